@@ -0,0 +1,286 @@
+//*********************************************************************************
+// Button Debouncer Allocation Check
+// 
+// Description:
+// Checks that the structures taking a DebouncerArena do all of their
+// allocating up front. Every structure is built from one arena, then malloc
+// and its relatives are trapped while the structures run through a few
+// thousand ticks. The check fails if anything is allocated during the ticks
+// or if the arena ran out and a structure fell back to the heap.
+// 
+// malloc, its relatives and the aligned allocators are replaced by
+// forwarding to glibc's own entry points, so this only builds on Linux with
+// glibc. operator new, aligned or not, ends up in one of them there, so it
+// is trapped as well.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include "button_debounce_arena.h"
+#include "button_debounce_bank.h"
+#include "button_debounce_broadcast.h"
+#include "button_debounce_hotcold.h"
+#include "button_debounce_index.h"
+#include "button_debounce_lazy.h"
+#include "button_debounce_multirate.h"
+#include "button_debounce_notify.h"
+#include "button_debounce_partition.h"
+#include "button_debounce_registry.h"
+#include "button_debounce_sparse.h"
+#include "button_debounce_stagger.h"
+#include "button_debounce_wait.h"
+
+// The number of ports in each structure
+#define CHECK_PORTS             3000
+
+// The number of ticks run with malloc trapped
+#define CHECK_TICKS             2000
+
+// The size of the arena everything is built from
+#define CHECK_ARENA_SIZE        (64 * 1024 * 1024)
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *memory, size_t size);
+extern "C" void *__libc_memalign(size_t alignment, size_t size);
+
+// Whether allocations are being counted, and how many there were
+static std::atomic<bool> trapping(false);
+static std::atomic<unsigned long> trapped(0);
+
+static void
+Trap()
+{
+    if(trapping.load(std::memory_order_relaxed))
+    {
+        trapped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+extern "C" void *
+malloc(size_t size)
+{
+    Trap();
+    return __libc_malloc(size);
+}
+
+extern "C" void *
+calloc(size_t count, size_t size)
+{
+    Trap();
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *
+realloc(void *memory, size_t size)
+{
+    Trap();
+    return __libc_realloc(memory, size);
+}
+
+extern "C" int
+posix_memalign(void **memory, size_t alignment, size_t size)
+{
+    Trap();
+    *memory = __libc_memalign(alignment, size);
+
+    return *memory != NULL ? 0 : ENOMEM;
+}
+
+// Aligned operator new and DebouncerHeapAllocate end up in one of these
+extern "C" void *
+aligned_alloc(size_t alignment, size_t size)
+{
+    Trap();
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" void *
+memalign(size_t alignment, size_t size)
+{
+    Trap();
+    return __libc_memalign(alignment, size);
+}
+
+static uint32_t
+NextRandom(uint32_t &seed)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    return seed;
+}
+
+int
+main()
+{
+    DebouncerArena arena(CHECK_ARENA_SIZE);
+    DebouncerBank bank(CHECK_PORTS, 0x00, &arena);
+    DebouncerEventRing ring(1024, BUTTON_BROADCAST_OVERWRITE, &arena);
+    DebouncerEventConsumer consumer;
+    DebouncerWaitTable wait(CHECK_PORTS, &arena);
+    HotColdDebouncerBank hotCold(CHECK_PORTS, 0x00, &arena);
+    DebouncerIdIndex index(CHECK_PORTS, &arena);
+    LazyDebouncerBank lazy(CHECK_PORTS, 16, 0x00, &arena);
+    SparseDebouncerEngine sparse(CHECK_PORTS, 500, 0x00, &arena);
+    DebouncerRegistry registry(CHECK_PORTS, &arena);
+    StaggeredDebouncerBank staggered(CHECK_PORTS, 4, 0x00, &arena);
+    MultiRateDebouncerEngine multiRate(2, &arena);
+    DebouncerNotifier notifier(CHECK_PORTS, CHECK_PORTS, &arena);
+    uint32_t partitionPorts[3] = {1000, 1000, 1000};
+    PartitionedDebouncerBank partitioned(3, partitionPorts, 0x00, 256, &arena);
+    static uint8_t portStatus[CHECK_PORTS];
+    static uint8_t scattered[CHECK_PORTS];
+    static uint32_t ids[CHECK_PORTS];
+    DebouncerPartition *partition;
+    DebouncerHandle handle;
+    DebouncerEvent event;
+    uint32_t seed = 12345;
+    uint8_t pullType = 0x00;
+    uint8_t *samples;
+    int subscriber;
+    uint32_t port;
+    uint32_t tick;
+    uint32_t i;
+
+    // Everything that may allocate happens before the trap is set
+    consumer.Attach(ring, 0xFF);
+    for(i = 0; i < CHECK_PORTS; i++)
+    {
+        ids[i] = i * 7919u;
+        index.Insert(ids[i], i);
+    }
+    for(i = 0; i < CHECK_PORTS / 2; i++)
+    {
+        registry.Add(pullType);
+    }
+    multiRate.AddGroup(1000, 1, 0x00);
+    multiRate.AddGroup(2000, 5, 0x00);
+    multiRate.Start();
+    for(i = 0; i < 4; i++)
+    {
+        subscriber = notifier.AddSubscriber();
+        for(port = i; port < CHECK_PORTS; port += 4)
+        {
+            notifier.Subscribe(subscriber, port, (uint8_t)(1 << i));
+        }
+    }
+
+    trapping.store(true, std::memory_order_relaxed);
+
+    for(tick = 0; tick < CHECK_TICKS; tick++)
+    {
+        for(i = 0; i < CHECK_PORTS / 30; i++)
+        {
+            portStatus[NextRandom(seed) % CHECK_PORTS] = (uint8_t)NextRandom(seed);
+        }
+
+        bank.ButtonProcess(portStatus);
+        ring.Publish(bank, 0, 0);
+        while(consumer.Poll(event))
+        {
+        }
+        wait.Publish(bank, 0);
+        notifier.Note(bank, 0);
+        notifier.Flush();
+        if(tick % 10 == 0)
+        {
+            notifier.Acknowledge(tick % 4);
+        }
+
+        DebouncerBank::ChangedIterator it(bank, 0);
+        while(it.Next(port))
+        {
+        }
+
+        hotCold.ButtonProcess(portStatus);
+        if(tick % 500 == 0)
+        {
+            hotCold.Reorder();
+        }
+
+        index.IngestTagged(ids, portStatus, CHECK_PORTS, scattered);
+
+        lazy.ButtonProcess(portStatus);
+        lazy.ButtonCurrent(tick % CHECK_PORTS, 0xFF);
+        if(tick % 100 == 0)
+        {
+            lazy.Evaluate(0, CHECK_PORTS);
+        }
+
+        sparse.ButtonProcess(portStatus);
+
+        // Devices coming and going reuse the registry's slots
+        registry.ButtonProcess(portStatus);
+        if(tick % 50 == 0)
+        {
+            registry.Remove(registry.HandleOf(0));
+            handle = registry.Add(pullType);
+            (void)handle;
+        }
+
+        staggered.ButtonProcess(portStatus);
+
+        for(i = 0; i < 2; i++)
+        {
+            if(multiRate.GroupDue(i))
+            {
+                samples = multiRate.GroupSamples(i);
+                memcpy(samples, portStatus, 10);
+            }
+        }
+        multiRate.Tick();
+
+        for(i = 0; i < partitioned.NumPartitions(); i++)
+        {
+            partition = partitioned.Claim(i);
+            partition->ButtonProcess(portStatus + partition->FirstPort());
+            partitioned.Release(partition);
+        }
+    }
+
+    trapping.store(false, std::memory_order_relaxed);
+
+    printf("%lu allocations during %u ticks, %zu bytes of arena used, "
+           "%u heap fallbacks\n", trapped.load(), CHECK_TICKS, arena.Used(),
+           arena.Fallbacks());
+
+    if(trapped.load() != 0 || arena.Fallbacks() != 0)
+    {
+        printf("FAILED\n");
+        return 1;
+    }
+
+    printf("PASSED\n");
+
+    return 0;
+}
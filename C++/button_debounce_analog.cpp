@@ -0,0 +1,199 @@
+//*********************************************************************************
+// State Button Debouncer - Analog Inputs
+// 
+// Revision: 1.0
+// 
+// Description: Turns ADC readings into port statuses. See
+// button_debounce_analog.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "button_debounce_analog.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// The number of channels on one port
+#define BUTTON_ANALOG_PORT_CHANNELS 8
+
+//*********************************************************************************
+// Local Functions
+//*********************************************************************************
+
+// 
+// Works out one port's pins from up to 8 readings, one channel at a time
+// 
+static uint8_t
+ConvertPort(const uint16_t *samples, const uint16_t *low, const uint16_t *high,
+            uint32_t count, uint8_t pins)
+{
+    uint32_t i;
+
+    for(i = 0; i < count; i++)
+    {
+        if(samples[i] >= high[i])
+        {
+            pins |= (1 << i);
+        }
+        else if(samples[i] < low[i])
+        {
+            pins &= ~(1 << i);
+        }
+    }
+
+    return pins;
+}
+
+//*********************************************************************************
+// Class Functions
+//*********************************************************************************
+AnalogThresholdStage::
+AnalogThresholdStage(uint32_t numChannels, uint16_t lowThreshold, uint16_t highThreshold,
+                     DebouncerArena *arena)
+{
+    uint32_t i;
+
+    this->numChannels = numChannels;
+    this->arena = arena;
+    numPorts = (numChannels + (BUTTON_ANALOG_PORT_CHANNELS - 1)) / BUTTON_ANALOG_PORT_CHANNELS;
+
+    low = DebouncerAllocate<uint16_t>(arena, numChannels);
+    high = DebouncerAllocate<uint16_t>(arena, numChannels);
+    ports = DebouncerAllocate<uint8_t>(arena, numPorts);
+
+    for(i = 0; i < numChannels; i++)
+    {
+        low[i] = lowThreshold;
+        high[i] = highThreshold;
+    }
+    memset(ports, 0x00, numPorts);
+}
+
+AnalogThresholdStage::
+~AnalogThresholdStage()
+{
+    DebouncerFree(arena, low, numChannels);
+    DebouncerFree(arena, high, numChannels);
+    DebouncerFree(arena, ports, numPorts);
+}
+
+void AnalogThresholdStage::
+SetThresholds(uint32_t channel, uint16_t lowThreshold, uint16_t highThreshold)
+{
+    low[channel] = lowThreshold;
+    high[channel] = highThreshold;
+}
+
+const uint8_t *AnalogThresholdStage::
+Convert(const uint16_t *samples)
+{
+    const uint32_t fullPorts = numChannels / BUTTON_ANALOG_PORT_CHANNELS;
+    uint32_t port = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sample;
+    __m128i on;
+    __m128i stay;
+    uint32_t mask;
+
+    // SSE2 has no unsigned 16 bit compares, but a saturating subtraction
+    // is 0 exactly when the reading is at least the threshold. The two
+    // compare results are packed into bytes so that one movemask gives the
+    // pins reaching the high threshold in its low 8 bits and the pins not
+    // below the low threshold in its high 8 bits.
+    for(; port < fullPorts; port++)
+    {
+        sample = _mm_loadu_si128((const __m128i *)(samples + port * BUTTON_ANALOG_PORT_CHANNELS));
+        on = _mm_cmpeq_epi16(_mm_subs_epu16(_mm_loadu_si128((const __m128i *)
+                             (high + port * BUTTON_ANALOG_PORT_CHANNELS)), sample), zero);
+        stay = _mm_cmpeq_epi16(_mm_subs_epu16(_mm_loadu_si128((const __m128i *)
+                               (low + port * BUTTON_ANALOG_PORT_CHANNELS)), sample), zero);
+        mask = (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(on, stay));
+
+        ports[port] = (uint8_t)mask | (ports[port] & (uint8_t)(mask >> 8));
+    }
+#endif
+
+    for(; port < fullPorts; port++)
+    {
+        ports[port] = ConvertPort(samples + port * BUTTON_ANALOG_PORT_CHANNELS,
+                                  low + port * BUTTON_ANALOG_PORT_CHANNELS,
+                                  high + port * BUTTON_ANALOG_PORT_CHANNELS,
+                                  BUTTON_ANALOG_PORT_CHANNELS, ports[port]);
+    }
+
+    // The last port may only be partly used
+    if(port < numPorts)
+    {
+        ports[port] = ConvertPort(samples + port * BUTTON_ANALOG_PORT_CHANNELS,
+                                  low + port * BUTTON_ANALOG_PORT_CHANNELS,
+                                  high + port * BUTTON_ANALOG_PORT_CHANNELS,
+                                  numChannels - port * BUTTON_ANALOG_PORT_CHANNELS,
+                                  ports[port]);
+    }
+
+    return ports;
+}
+
+void AnalogThresholdStage::
+ButtonProcess(const uint16_t *samples, DebouncerBank &bank)
+{
+    bank.ButtonProcess(Convert(samples));
+}
+
+void AnalogThresholdStage::
+ButtonProcess(const uint16_t *samples, Debouncer *debouncers)
+{
+    uint32_t port;
+
+    Convert(samples);
+
+    for(port = 0; port < numPorts; port++)
+    {
+        debouncers[port].ButtonProcess(ports[port]);
+    }
+}
+
+uint32_t AnalogThresholdStage::
+NumChannels() const
+{
+    return numChannels;
+}
+
+uint32_t AnalogThresholdStage::
+NumPorts() const
+{
+    return numPorts;
+}
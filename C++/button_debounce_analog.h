@@ -0,0 +1,158 @@
+//*********************************************************************************
+// State Button Debouncer - Analog Inputs
+// 
+// Revision: 1.0
+// 
+// Description: Turns ADC readings into port statuses so that analog inputs
+// such as hall sensors or force sensitive pads can be debounced like any
+// other button. Every channel has a high and a low threshold: the channel's
+// pin goes to 1 once a reading reaches the high threshold and back to 0 once
+// a reading drops below the low one, and keeps its level in between. The gap
+// between the thresholds keeps noise around a single threshold from toggling
+// the pin on every reading.
+// 
+// Channel c becomes pin c % 8 of port c / 8, so the port statuses can go
+// straight into a DebouncerBank or an array of Debouncers. A pin is 1 for a
+// high reading; inputs that read low when pressed are handled by setting
+// their pins as pulled up in the debouncer.
+// 
+// On processors with SSE2 eight channels, one port, are compared at a time.
+// Otherwise the channels are compared one by one.
+// 
+// Requires C++11.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_ANALOG_H
+#define BUTTON_DEBOUNCER_ANALOG_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include "button_debounce.h"
+#include "button_debounce_arena.h"
+#include "button_debounce_bank.h"
+
+//*********************************************************************************
+// Class
+//*********************************************************************************
+
+class
+AnalogThresholdStage
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Initializes every channel with the same thresholds and its pin
+        //      at 0.
+        // Parameters:
+        //      numChannels - The number of ADC channels.
+        //      lowThreshold - Readings below this turn a pin off.
+        //      highThreshold - Readings at or above this turn a pin on. Must
+        //          not be below lowThreshold.
+        //      arena - Where to allocate the stage from, or NULL for the
+        //          heap.
+        // Returns:
+        //      None
+        // 
+        AnalogThresholdStage(uint32_t numChannels, uint16_t lowThreshold,
+                             uint16_t highThreshold, DebouncerArena *arena = NULL);
+        ~AnalogThresholdStage();
+
+        // 
+        // Set Thresholds
+        // Description:
+        //      Changes the thresholds of one channel.
+        // Parameters:
+        //      channel - The channel.
+        //      lowThreshold - Readings below this turn the pin off.
+        //      highThreshold - Readings at or above this turn the pin on.
+        // Returns:
+        //      None
+        // 
+        void SetThresholds(uint32_t channel, uint16_t lowThreshold, uint16_t highThreshold);
+
+        // 
+        // Convert
+        // Description:
+        //      Updates the pin of every channel from a set of readings.
+        // Parameters:
+        //      samples - One reading per channel.
+        // Returns:
+        //      The port statuses, (numChannels + 7) / 8 bytes. Pins past the
+        //      last channel are 0. Valid until the next call.
+        // 
+        const uint8_t *Convert(const uint16_t *samples);
+
+        // 
+        // Button Process
+        // Description:
+        //      Converts a set of readings and debounces the resulting ports.
+        // Parameters:
+        //      samples - One reading per channel.
+        //      bank - A bank with one port per 8 channels, or
+        //      debouncers - An array with one Debouncer per 8 channels.
+        // Returns:
+        //      None
+        // 
+        void ButtonProcess(const uint16_t *samples, DebouncerBank &bank);
+        void ButtonProcess(const uint16_t *samples, Debouncer *debouncers);
+
+        // 
+        // Num Channels and Num Ports
+        // Description:
+        //      Get the number of channels and the number of ports they fill.
+        // 
+        uint32_t NumChannels() const;
+        uint32_t NumPorts() const;
+
+    private:
+        AnalogThresholdStage(const AnalogThresholdStage &);
+        AnalogThresholdStage &operator=(const AnalogThresholdStage &);
+
+        uint32_t numChannels;
+        uint32_t numPorts;
+        DebouncerArena *arena;
+
+        // 
+        // The thresholds of each channel
+        // 
+        uint16_t *low;
+        uint16_t *high;
+
+        // 
+        // The current pins, one byte per port
+        // 
+        uint8_t *ports;
+};
+
+#endif  // BUTTON_DEBOUNCER_ANALOG_H
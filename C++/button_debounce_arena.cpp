@@ -0,0 +1,326 @@
+//*********************************************************************************
+// State Button Debouncer - Arena
+// 
+// Revision: 1.0
+// 
+// Description: A simple bump allocator for the multi-port structures of this
+// library. See button_debounce_arena.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdlib.h>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include "button_debounce_arena.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// The size of an explicit huge page
+#define BUTTON_ARENA_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// The mbind memory policy that prefers one node but falls back to others
+// when it is full. Defined here so that libnuma isn't needed.
+#define BUTTON_ARENA_MPOL_PREFERRED 1
+
+//*********************************************************************************
+// Local Functions
+//*********************************************************************************
+
+#if defined(__linux__)
+// 
+// Asks the kernel to place a mapping on a node
+// 
+static void
+BindToNode(void *memory, size_t size, int numaNode)
+{
+    unsigned long nodeMask[4] = {0, 0, 0, 0};
+    const unsigned long bitsPerWord = 8 * sizeof(unsigned long);
+
+    if(numaNode < 0 || (unsigned long)numaNode >= bitsPerWord * 4)
+    {
+        return;
+    }
+
+    nodeMask[numaNode / bitsPerWord] = 1UL << (numaNode % bitsPerWord);
+
+    // Failing to bind only costs performance, so the result is ignored
+    syscall(SYS_mbind, memory, size, BUTTON_ARENA_MPOL_PREFERRED, nodeMask,
+            bitsPerWord * 4 + 1, 0);
+}
+#endif
+
+//*********************************************************************************
+// Class Functions
+//*********************************************************************************
+DebouncerArena::
+DebouncerArena(void *buffer, size_t size)
+{
+    this->buffer = (uint8_t *)buffer;
+    capacity = size;
+    used = 0;
+    fallbacks = 0;
+    ownedBuffer = NULL;
+    mappedSize = 0;
+    hugePages = BUTTON_ARENA_MAP_DEFAULT;
+#if __cplusplus >= 201703L
+    resource = NULL;
+#endif
+}
+
+DebouncerArena::
+DebouncerArena(size_t size)
+{
+    ownedBuffer = new uint8_t[size];
+    buffer = ownedBuffer;
+    capacity = size;
+    used = 0;
+    fallbacks = 0;
+    mappedSize = 0;
+    hugePages = BUTTON_ARENA_MAP_DEFAULT;
+#if __cplusplus >= 201703L
+    resource = NULL;
+#endif
+}
+
+DebouncerArena::
+DebouncerArena(size_t size, uint32_t mapFlags, int numaNode)
+{
+#if defined(__linux__)
+    void *mapping = MAP_FAILED;
+    size_t hugeSize = (size + (BUTTON_ARENA_HUGE_PAGE_SIZE - 1)) &
+                      ~(size_t)(BUTTON_ARENA_HUGE_PAGE_SIZE - 1);
+#endif
+
+    used = 0;
+    fallbacks = 0;
+    ownedBuffer = NULL;
+    buffer = NULL;
+    capacity = size;
+    mappedSize = 0;
+    hugePages = BUTTON_ARENA_MAP_DEFAULT;
+#if __cplusplus >= 201703L
+    resource = NULL;
+#endif
+
+#if defined(__linux__)
+    if(mapFlags & BUTTON_ARENA_MAP_HUGETLB)
+    {
+        mapping = mmap(NULL, hugeSize, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if(mapping != MAP_FAILED)
+        {
+            mappedSize = hugeSize;
+            hugePages = BUTTON_ARENA_MAP_HUGETLB;
+        }
+        else
+        {
+            mapFlags |= BUTTON_ARENA_MAP_THP;
+        }
+    }
+
+    if(mapping == MAP_FAILED)
+    {
+        // Transparent huge pages are only used for whole, aligned huge pages
+        // so map the block that way when asking for them
+        mappedSize = (mapFlags & BUTTON_ARENA_MAP_THP) ? hugeSize : size;
+        mapping = mmap(NULL, mappedSize, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(mapping == MAP_FAILED)
+        {
+            mappedSize = 0;
+        }
+        else if(mapFlags & BUTTON_ARENA_MAP_THP)
+        {
+            madvise(mapping, mappedSize, MADV_HUGEPAGE);
+            hugePages = BUTTON_ARENA_MAP_THP;
+        }
+    }
+
+    if(mapping != MAP_FAILED)
+    {
+        BindToNode(mapping, mappedSize, numaNode);
+        buffer = (uint8_t *)mapping;
+        return;
+    }
+#else
+    (void)mapFlags;
+    (void)numaNode;
+#endif
+
+    ownedBuffer = new uint8_t[size];
+    buffer = ownedBuffer;
+}
+
+#if __cplusplus >= 201703L
+DebouncerArena::
+DebouncerArena(size_t size, std::pmr::memory_resource *resource)
+{
+    this->resource = resource;
+    ownedBuffer = NULL;
+    buffer = (uint8_t *)resource->allocate(size, alignof(std::max_align_t));
+    capacity = size;
+    used = 0;
+    fallbacks = 0;
+    mappedSize = 0;
+    hugePages = BUTTON_ARENA_MAP_DEFAULT;
+}
+#endif
+
+DebouncerArena::
+~DebouncerArena()
+{
+#if __cplusplus >= 201703L
+    if(resource != NULL)
+    {
+        resource->deallocate(buffer, capacity, alignof(std::max_align_t));
+    }
+#endif
+#if defined(__linux__)
+    if(mappedSize != 0)
+    {
+        munmap(buffer, mappedSize);
+    }
+#endif
+    delete[] ownedBuffer;
+}
+
+void *DebouncerArena::
+Allocate(size_t size, size_t alignment)
+{
+    uintptr_t start = ((uintptr_t)buffer + used + (alignment - 1)) & ~(uintptr_t)(alignment - 1);
+    size_t offset = start - (uintptr_t)buffer;
+
+    if(offset > capacity || size > capacity - offset)
+    {
+        return NULL;
+    }
+
+    used = offset + size;
+
+    return buffer + offset;
+}
+
+bool DebouncerArena::
+Owns(const void *memory) const
+{
+    // A zero size allocation taken when the arena is full points just past
+    // its end, so the end counts as the arena's too
+    return (const uint8_t *)memory >= buffer && (const uint8_t *)memory <= buffer + capacity;
+}
+
+void DebouncerArena::
+NoteFallback()
+{
+    fallbacks++;
+}
+
+size_t DebouncerArena::
+Used() const
+{
+    return used;
+}
+
+size_t DebouncerArena::
+Capacity() const
+{
+    return capacity;
+}
+
+uint32_t DebouncerArena::
+Fallbacks() const
+{
+    return fallbacks;
+}
+
+uint32_t DebouncerArena::
+HugePages() const
+{
+    return hugePages;
+}
+
+bool DebouncerArena::
+Zeroed() const
+{
+    return mappedSize != 0;
+}
+
+//*********************************************************************************
+// Functions
+//*********************************************************************************
+void *
+DebouncerHeapAllocate(size_t size, size_t alignment)
+{
+    void *memory;
+
+    // posix_memalign needs at least pointer alignment, and a size of 0 may
+    // give NULL
+    if(alignment < sizeof(void *))
+    {
+        alignment = sizeof(void *);
+    }
+    if(size == 0)
+    {
+        size = 1;
+    }
+
+#if defined(_WIN32)
+    memory = _aligned_malloc(size, alignment);
+#else
+    if(posix_memalign(&memory, alignment, size) != 0)
+    {
+        memory = NULL;
+    }
+#endif
+
+    if(memory == NULL)
+    {
+        throw std::bad_alloc();
+    }
+
+    return memory;
+}
+
+void
+DebouncerHeapFree(void *memory)
+{
+#if defined(_WIN32)
+    _aligned_free(memory);
+#else
+    free(memory);
+#endif
+}
@@ -0,0 +1,398 @@
+//*********************************************************************************
+// State Button Debouncer - Arena
+// 
+// Revision: 1.0
+// 
+// Description: A simple bump allocator that the multi-port structures of this
+// library can take all of their memory from. Handing a structure an arena
+// means that it allocates everything in its constructor and nothing
+// afterwards, so processing and querying it never goes near the heap. The
+// arena can carve its memory out of a buffer supplied by the application,
+// allocate one block up front or, with C++17, take one block from a
+// std::pmr::memory_resource.
+// 
+// Memory is only given back when the arena is destroyed, so an arena must
+// outlive every structure that uses it. When an arena runs out, structures
+// fall back to the heap and the arena counts the fallback so that this can
+// be caught during testing.
+// 
+// On Linux an arena can also map its memory directly, backed by huge pages
+// and placed on a chosen NUMA node. Banks of millions of ports then need far
+// fewer TLB entries, and the shards of a partitioned bank can each live on
+// the node of the thread that processes them.
+// 
+// An arena must only be used by one thread at a time. Requires C++11.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_ARENA_H
+#define BUTTON_DEBOUNCER_ARENA_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stddef.h>
+#include <stdint.h>
+#include <new>
+#include <utility>
+#if __cplusplus >= 201703L
+#include <memory_resource>
+#endif
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// Mapping options for arenas that map their own memory
+#define BUTTON_ARENA_MAP_DEFAULT    0x00
+
+// Back the arena with explicitly reserved huge pages (see
+// /proc/sys/vm/nr_hugepages). If none are available, this falls back to
+// BUTTON_ARENA_MAP_THP.
+#define BUTTON_ARENA_MAP_HUGETLB    0x01
+
+// Ask for transparent huge pages
+#define BUTTON_ARENA_MAP_THP        0x02
+
+// Place the memory on any NUMA node
+#define BUTTON_ARENA_ANY_NODE       (-1)
+
+//*********************************************************************************
+// Class
+//*********************************************************************************
+
+class
+DebouncerArena
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Hands out memory from a buffer owned by the application.
+        // Parameters:
+        //      buffer - The buffer. Must outlive the arena.
+        //      size - The size of the buffer in bytes.
+        // Returns:
+        //      None
+        // 
+        DebouncerArena(void *buffer, size_t size);
+
+        // 
+        // Constructor
+        // Description:
+        //      Allocates one block of memory from the heap to hand out.
+        // Parameters:
+        //      size - The size of the block in bytes.
+        // Returns:
+        //      None
+        // 
+        DebouncerArena(size_t size);
+
+        // 
+        // Constructor
+        // Description:
+        //      Maps a block of memory to hand out. The pages are only touched
+        //      when used, so they are placed on the chosen node as the
+        //      structures built in the arena first write them. Where mapping
+        //      isn't supported this allocates from the heap like the
+        //      constructor above.
+        // Parameters:
+        //      size - The size of the block in bytes. Rounded up to a whole
+        //          number of huge pages when BUTTON_ARENA_MAP_HUGETLB is used.
+        //      mapFlags - The ORed BUTTON_ARENA_MAP_* options.
+        //      numaNode - The NUMA node the memory should preferably be on,
+        //          or BUTTON_ARENA_ANY_NODE.
+        // Returns:
+        //      None
+        // 
+        DebouncerArena(size_t size, uint32_t mapFlags, int numaNode);
+
+#if __cplusplus >= 201703L
+        // 
+        // Constructor
+        // Description:
+        //      Allocates one block of memory from a memory resource to hand
+        //      out. The block is given back to the resource by the
+        //      destructor.
+        // Parameters:
+        //      size - The size of the block in bytes.
+        //      resource - The memory resource. Must outlive the arena.
+        // Returns:
+        //      None
+        // 
+        DebouncerArena(size_t size, std::pmr::memory_resource *resource);
+#endif
+
+        ~DebouncerArena();
+
+        // 
+        // Allocate
+        // Description:
+        //      Takes memory from the arena.
+        // Parameters:
+        //      size - The number of bytes needed.
+        //      alignment - The alignment needed. Must be a power of two.
+        // Returns:
+        //      The memory, or NULL if the arena doesn't have enough left.
+        // 
+        void *Allocate(size_t size, size_t alignment);
+
+        // 
+        // Owns
+        // Description:
+        //      Checks whether memory came from this arena. A pointer just past
+        //      the end of the arena is included, since that is where a zero
+        //      size allocation from a full arena points.
+        // 
+        bool Owns(const void *memory) const;
+
+        // 
+        // Note Fallback
+        // Description:
+        //      Records that a structure had to use the heap because the arena
+        //      ran out.
+        // 
+        void NoteFallback();
+
+        // 
+        // Used, Capacity and Fallbacks
+        // Description:
+        //      Get the number of bytes handed out so far, the size of the
+        //      arena and the number of allocations that fell back to the
+        //      heap.
+        // 
+        size_t Used() const;
+        size_t Capacity() const;
+        uint32_t Fallbacks() const;
+
+        // 
+        // Huge Pages
+        // Description:
+        //      Gets which kind of huge pages the arena's mapping got:
+        //      BUTTON_ARENA_MAP_HUGETLB, BUTTON_ARENA_MAP_THP (as a request
+        //      the kernel may or may not act on) or BUTTON_ARENA_MAP_DEFAULT.
+        // 
+        uint32_t HugePages() const;
+
+        // 
+        // Zeroed
+        // Description:
+        //      Checks whether all memory handed out by the arena is known to
+        //      be zeros. This is the case when the arena mapped its memory,
+        //      since fresh anonymous pages read as zeros and the arena never
+        //      hands the same memory out twice.
+        // 
+        bool Zeroed() const;
+
+    private:
+        DebouncerArena(const DebouncerArena &);
+        DebouncerArena &operator=(const DebouncerArena &);
+
+        uint8_t *buffer;
+        size_t capacity;
+        size_t used;
+        uint32_t fallbacks;
+
+        // 
+        // Where the buffer came from when the arena allocated it itself
+        // 
+        uint8_t *ownedBuffer;
+
+        // 
+        // The size of the mapping when the arena mapped its memory itself
+        // 
+        size_t mappedSize;
+        uint32_t hugePages;
+#if __cplusplus >= 201703L
+        std::pmr::memory_resource *resource;
+#endif
+};
+
+//*********************************************************************************
+// Functions
+//*********************************************************************************
+
+// 
+// Debouncer Heap Allocate
+// Description:
+//      Allocates memory from the heap with any alignment. Plain new only
+//      honours alignments above that of max_align_t from C++17 on, and the
+//      structures here are aligned to cache lines.
+// Parameters:
+//      size - The number of bytes needed.
+//      alignment - The alignment needed. Must be a power of two.
+// Returns:
+//      The memory. Throws std::bad_alloc like new if there is none left.
+// 
+void *DebouncerHeapAllocate(size_t size, size_t alignment);
+
+// 
+// Debouncer Heap Free
+// Description:
+//      Frees memory allocated by DebouncerHeapAllocate.
+// Parameters:
+//      memory - The memory, or NULL.
+// Returns:
+//      None
+// 
+void DebouncerHeapFree(void *memory);
+
+// 
+// Debouncer Allocate
+// Description:
+//      Allocates and default constructs an array, from the arena if one is
+//      given and it has room and from the heap otherwise.
+// Parameters:
+//      arena - The arena, or NULL.
+//      count - The number of elements.
+// Returns:
+//      The array. Free it with DebouncerFree.
+// 
+template<class T> T *
+DebouncerAllocate(DebouncerArena *arena, size_t count)
+{
+    void *memory = NULL;
+    size_t i;
+
+    if(arena != NULL)
+    {
+        memory = arena->Allocate(sizeof(T) * count, alignof(T));
+        if(memory == NULL)
+        {
+            arena->NoteFallback();
+        }
+    }
+
+    if(memory == NULL)
+    {
+        memory = DebouncerHeapAllocate(sizeof(T) * count, alignof(T));
+    }
+
+    for(i = 0; i < count; i++)
+    {
+        new((T *)memory + i) T;
+    }
+
+    return (T *)memory;
+}
+
+// 
+// Debouncer Free
+// Description:
+//      Destroys an array allocated by DebouncerAllocate. Arena memory is only
+//      given back when the arena is destroyed.
+// Parameters:
+//      arena - The arena the array was allocated with, or NULL.
+//      objects - The array.
+//      count - The number of elements.
+// Returns:
+//      None
+// 
+template<class T> void
+DebouncerFree(DebouncerArena *arena, T *objects, size_t count)
+{
+    size_t i;
+
+    if(objects == NULL)
+    {
+        return;
+    }
+
+    for(i = 0; i < count; i++)
+    {
+        objects[i].~T();
+    }
+
+    if(arena == NULL || !arena->Owns(objects))
+    {
+        DebouncerHeapFree(objects);
+    }
+}
+
+// 
+// Debouncer New
+// Description:
+//      Allocates and constructs one object, from the arena if one is given
+//      and it has room and from the heap otherwise.
+// Parameters:
+//      arena - The arena, or NULL.
+//      args - The constructor arguments.
+// Returns:
+//      The object. Free it with DebouncerDelete.
+// 
+template<class T, class... Args> T *
+DebouncerNew(DebouncerArena *arena, Args &&... args)
+{
+    void *memory = NULL;
+
+    if(arena != NULL)
+    {
+        memory = arena->Allocate(sizeof(T), alignof(T));
+        if(memory == NULL)
+        {
+            arena->NoteFallback();
+        }
+    }
+
+    if(memory == NULL)
+    {
+        memory = DebouncerHeapAllocate(sizeof(T), alignof(T));
+    }
+
+    return new(memory) T(std::forward<Args>(args)...);
+}
+
+// 
+// Debouncer Delete
+// Description:
+//      Destroys an object allocated by DebouncerNew.
+// Parameters:
+//      arena - The arena the object was allocated with, or NULL.
+//      object - The object.
+// Returns:
+//      None
+// 
+template<class T> void
+DebouncerDelete(DebouncerArena *arena, T *object)
+{
+    if(object == NULL)
+    {
+        return;
+    }
+
+    object->~T();
+
+    if(arena == NULL || !arena->Owns(object))
+    {
+        DebouncerHeapFree(object);
+    }
+}
+
+#endif  // BUTTON_DEBOUNCER_ARENA_H
@@ -0,0 +1,603 @@
+//*********************************************************************************
+// State Button Debouncer - Debouncer Bank
+// 
+// Revision: 1.0
+// 
+// Description: Debounces a large number of 8 bit ports in one pass. See
+// button_debounce_bank.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <string.h>
+#include "button_debounce_bank.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// Each processing chunk is summarized by exactly one summary word
+#if BUTTON_BANK_ALIGNMENT != BUTTON_BANK_SUMMARY_BITS
+#error "BUTTON_BANK_ALIGNMENT must match BUTTON_BANK_SUMMARY_BITS"
+#endif
+
+//*********************************************************************************
+// Local Functions
+//*********************************************************************************
+
+// 
+// Rounds numPorts up to a whole number of BUTTON_BANK_ALIGNMENT bytes
+// 
+static uint32_t
+BankStride(uint32_t numPorts)
+{
+    return (numPorts + (BUTTON_BANK_ALIGNMENT - 1)) &
+           ~(uint32_t)(BUTTON_BANK_ALIGNMENT - 1);
+}
+
+// 
+// Gets the number of words needed to hold one bit for each of numBits
+// 
+static uint32_t
+SummaryWords(uint32_t numBits)
+{
+    return (numBits + (BUTTON_BANK_SUMMARY_BITS - 1)) / BUTTON_BANK_SUMMARY_BITS;
+}
+
+// 
+// Gets the size of the pressed pin count and the summary bitmaps of a bank,
+// rounded up to a whole number of BUTTON_BANK_ALIGNMENT bytes
+// 
+static size_t
+SummarySize(uint32_t stride)
+{
+    uint32_t chunks = stride / BUTTON_BANK_ALIGNMENT;
+    uint32_t groupWords = SummaryWords(chunks);
+    size_t size = sizeof(uint64_t) * (1 + chunks + groupWords + SummaryWords(groupWords));
+
+    return (size + (BUTTON_BANK_ALIGNMENT - 1)) & ~(size_t)(BUTTON_BANK_ALIGNMENT - 1);
+}
+
+// 
+// Sets one bit of summary for every non zero word of words
+// 
+static void
+Summarize(const uint64_t *words, uint32_t numWords, uint64_t *summary)
+{
+    uint64_t bits;
+    uint32_t word;
+    uint32_t i;
+
+    for(word = 0; word < numWords; word += BUTTON_BANK_SUMMARY_BITS)
+    {
+        bits = 0;
+        for(i = 0; i < BUTTON_BANK_SUMMARY_BITS && word + i < numWords; i++)
+        {
+            bits |= (uint64_t)(words[word + i] != 0) << i;
+        }
+        summary[word / BUTTON_BANK_SUMMARY_BITS] = bits;
+    }
+}
+
+// 
+// Gets a mask of the bits of a word from bit upwards. bit may be 64.
+// 
+static uint64_t
+BitsFrom(uint32_t bit)
+{
+    return bit < BUTTON_BANK_SUMMARY_BITS ? ~(uint64_t)0 << bit : 0;
+}
+
+//*********************************************************************************
+// Class Functions
+//*********************************************************************************
+size_t DebouncerBank::
+StorageSize(uint32_t numPorts)
+{
+    // The state arrays followed by the debounced state, changed and
+    // pull type arrays and then the summaries
+    return (size_t)BankStride(numPorts) * (NUM_BUTTON_STATES + 3) +
+           SummarySize(BankStride(numPorts));
+}
+
+DebouncerBank::
+DebouncerBank(uint32_t numPorts, uint8_t pulledUpButtons)
+{
+    uint8_t *aligned;
+
+    this->numPorts = numPorts;
+    stride = BankStride(numPorts);
+
+    // Allocate enough to be able to line the storage up on a
+    // BUTTON_BANK_ALIGNMENT boundary
+    ownedStorage = new uint8_t[StorageSize(numPorts) + BUTTON_BANK_ALIGNMENT - 1];
+    aligned = ownedStorage + ((BUTTON_BANK_ALIGNMENT -
+              ((uintptr_t)ownedStorage & (BUTTON_BANK_ALIGNMENT - 1))) &
+              (BUTTON_BANK_ALIGNMENT - 1));
+
+    Layout(aligned);
+    Format(pulledUpButtons, BUTTON_BANK_DEFAULT);
+}
+
+DebouncerBank::
+DebouncerBank(uint32_t numPorts, uint8_t pulledUpButtons, void *storage, uint32_t options)
+{
+    this->numPorts = numPorts;
+    stride = BankStride(numPorts);
+    ownedStorage = NULL;
+
+    Layout(storage);
+    Format(pulledUpButtons, options);
+}
+
+DebouncerBank::
+DebouncerBank(uint32_t numPorts, uint8_t pulledUpButtons, DebouncerArena *arena,
+              uint32_t options)
+{
+    void *storage = NULL;
+    uint8_t *aligned;
+
+    this->numPorts = numPorts;
+    stride = BankStride(numPorts);
+    ownedStorage = NULL;
+
+    if(arena != NULL)
+    {
+        storage = arena->Allocate(StorageSize(numPorts), BUTTON_BANK_ALIGNMENT);
+        if(storage == NULL)
+        {
+            arena->NoteFallback();
+        }
+        else if(arena->Zeroed())
+        {
+            options |= BUTTON_BANK_ZEROED_STORAGE;
+        }
+    }
+
+    if(storage == NULL)
+    {
+        options &= ~(uint32_t)BUTTON_BANK_ZEROED_STORAGE;
+        ownedStorage = new uint8_t[StorageSize(numPorts) + BUTTON_BANK_ALIGNMENT - 1];
+        aligned = ownedStorage + ((BUTTON_BANK_ALIGNMENT -
+                  ((uintptr_t)ownedStorage & (BUTTON_BANK_ALIGNMENT - 1))) &
+                  (BUTTON_BANK_ALIGNMENT - 1));
+        storage = aligned;
+    }
+
+    Layout(storage);
+    Format(pulledUpButtons, options);
+}
+
+DebouncerBank::
+DebouncerBank(const void *storage, uint32_t numPorts)
+{
+    this->numPorts = numPorts;
+    stride = BankStride(numPorts);
+    ownedStorage = NULL;
+
+    Layout((void *)storage);
+    index = 0;
+    sharedPullType = 0;
+    sharedPull = false;
+}
+
+DebouncerBank::
+~DebouncerBank()
+{
+    delete[] ownedStorage;
+}
+
+void DebouncerBank::
+Layout(void *storage)
+{
+    state = (uint8_t *)storage;
+    debouncedState = state + (size_t)stride * NUM_BUTTON_STATES;
+    changed = debouncedState + stride;
+    pullType = changed + stride;
+
+    numChunks = stride / BUTTON_BANK_ALIGNMENT;
+    numGroupWords = SummaryWords(numChunks);
+    numRootWords = SummaryWords(numGroupWords);
+    pressedPins = (uint64_t *)(pullType + stride);
+    portSummary = pressedPins + 1;
+    groupSummary = portSummary + numChunks;
+    rootSummary = groupSummary + numGroupWords;
+}
+
+void DebouncerBank::
+Format(uint8_t pulledUpButtons, uint32_t options)
+{
+    index = 0;
+    sharedPullType = pulledUpButtons;
+    sharedPull = (options & BUTTON_BANK_SHARED_PULL) != 0;
+
+    // The state arrays, the debounced states, the changed pins and the
+    // summaries all start out at 0 just like a newly constructed Debouncer
+    if(!(options & BUTTON_BANK_ZEROED_STORAGE))
+    {
+        memset(state, 0x00, (size_t)stride * (NUM_BUTTON_STATES + 2));
+        memset(pressedPins, 0x00, SummarySize(stride));
+    }
+
+    if(!sharedPull)
+    {
+        memset(pullType, pulledUpButtons, stride);
+    }
+}
+
+void DebouncerBank::
+SplitPullType()
+{
+    if(sharedPull)
+    {
+        memset(pullType, sharedPullType, stride);
+        sharedPull = false;
+    }
+}
+
+void DebouncerBank::
+SetPullType(uint32_t port, uint8_t pulledUpButtons)
+{
+    if(sharedPull && pulledUpButtons == sharedPullType)
+    {
+        return;
+    }
+
+    SplitPullType();
+    pullType[port] = pulledUpButtons;
+}
+
+void DebouncerBank::
+ResetPort(uint32_t port, uint8_t pulledUpButtons)
+{
+    uint8_t j;
+
+    __atomic_fetch_sub(pressedPins, (uint64_t)__builtin_popcount(debouncedState[port]),
+                       __ATOMIC_RELAXED);
+
+    for(j = 0; j < NUM_BUTTON_STATES; j++)
+    {
+        state[(size_t)stride * j + port] = 0;
+    }
+    debouncedState[port] = 0;
+    changed[port] = 0;
+    SetPullType(port, pulledUpButtons);
+
+    SummarizePort(port);
+}
+
+void DebouncerBank::
+MovePort(uint32_t fromPort, uint32_t toPort)
+{
+    uint8_t j;
+
+    // The moved pins stay pressed while the pins of the overwritten port go
+    __atomic_fetch_add(pressedPins,
+                       (uint64_t)__builtin_popcount(debouncedState[fromPort]) -
+                       (uint64_t)__builtin_popcount(debouncedState[toPort]),
+                       __ATOMIC_RELAXED);
+
+    for(j = 0; j < NUM_BUTTON_STATES; j++)
+    {
+        state[(size_t)stride * j + toPort] = state[(size_t)stride * j + fromPort];
+    }
+    debouncedState[toPort] = debouncedState[fromPort];
+    changed[toPort] = changed[fromPort];
+    if(!sharedPull)
+    {
+        pullType[toPort] = pullType[fromPort];
+    }
+
+    SummarizePort(toPort);
+}
+
+void DebouncerBank::
+SummarizePort(uint32_t port)
+{
+    uint32_t chunk = port / BUTTON_BANK_ALIGNMENT;
+    uint32_t groupWord = chunk / BUTTON_BANK_SUMMARY_BITS;
+    uint64_t bit;
+
+    bit = (uint64_t)1 << (port % BUTTON_BANK_ALIGNMENT);
+    portSummary[chunk] = changed[port] != 0 ? portSummary[chunk] | bit :
+                                              portSummary[chunk] & ~bit;
+
+    bit = (uint64_t)1 << (chunk % BUTTON_BANK_SUMMARY_BITS);
+    groupSummary[groupWord] = portSummary[chunk] != 0 ? groupSummary[groupWord] | bit :
+                                                        groupSummary[groupWord] & ~bit;
+
+    bit = (uint64_t)1 << (groupWord % BUTTON_BANK_SUMMARY_BITS);
+    rootSummary[groupWord / BUTTON_BANK_SUMMARY_BITS] =
+        groupSummary[groupWord] != 0 ? rootSummary[groupWord / BUTTON_BANK_SUMMARY_BITS] | bit :
+                                       rootSummary[groupWord / BUTTON_BANK_SUMMARY_BITS] & ~bit;
+}
+
+void DebouncerBank::
+ButtonProcess(const uint8_t *portStatus)
+{
+    ButtonProcessRange(0, numPorts, portStatus);
+    AdvanceIndex();
+}
+
+void DebouncerBank::
+ButtonProcessRange(uint32_t firstPort, uint32_t rangePorts, const uint8_t *portStatus)
+{
+    uint8_t debounced[BUTTON_BANK_ALIGNMENT];
+    uint8_t *newest = state + (size_t)stride * index;
+    const uint8_t *row;
+    int64_t pressedDelta = 0;
+    uint64_t bits;
+    uint64_t mask;
+    uint32_t port;
+    uint32_t offset;
+    uint32_t count;
+    uint32_t i;
+    uint8_t j;
+
+    // Work through the range one BUTTON_BANK_ALIGNMENT port chunk at a time.
+    // The inner loops run over neighbouring ports so that the compiler can
+    // turn them into wide vector operations.
+    for(port = firstPort; port < firstPort + rangePorts; port += count)
+    {
+        offset = port & (BUTTON_BANK_ALIGNMENT - 1);
+        count = BUTTON_BANK_ALIGNMENT - offset;
+        if(count > firstPort + rangePorts - port)
+        {
+            count = firstPort + rangePorts - port;
+        }
+
+        // Save the port statuses into the state array, flipping the pins
+        // that are pulled up so that a 1 bit always means pressed
+        if(sharedPull)
+        {
+            for(i = 0; i < count; i++)
+            {
+                newest[port + i] = portStatus[port - firstPort + i] ^ sharedPullType;
+            }
+        }
+        else
+        {
+            for(i = 0; i < count; i++)
+            {
+                newest[port + i] = portStatus[port - firstPort + i] ^ pullType[port + i];
+            }
+        }
+
+        // Debounce the buttons
+        for(i = 0; i < count; i++)
+        {
+            debounced[i] = 0xFF;
+        }
+        for(j = 0; j < NUM_BUTTON_STATES; j++)
+        {
+            row = state + (size_t)stride * j + port;
+            for(i = 0; i < count; i++)
+            {
+                debounced[i] &= row[i];
+            }
+        }
+
+        // Calculate what changed and save the new debounced states
+        for(i = 0; i < count; i++)
+        {
+            changed[port + i] = debounced[i] ^ debouncedState[port + i];
+            debouncedState[port + i] = debounced[i];
+        }
+
+        // Note which ports of the chunk changed
+        bits = 0;
+        for(i = 0; i < count; i++)
+        {
+            bits |= (uint64_t)(changed[port + i] != 0) << i;
+        }
+        mask = BitsFrom(offset) & ~BitsFrom(offset + count);
+        portSummary[port / BUTTON_BANK_ALIGNMENT] =
+            (portSummary[port / BUTTON_BANK_ALIGNMENT] & ~mask) | (bits << offset);
+
+        // Only the ports that changed can change the pressed pin count
+        while(bits != 0)
+        {
+            i = __builtin_ctzll(bits);
+            bits &= bits - 1;
+            pressedDelta += __builtin_popcount(changed[port + i] & debounced[i]);
+            pressedDelta -= __builtin_popcount(changed[port + i] & ~debounced[i]);
+        }
+    }
+
+    // Ranges may be processed by several threads at once
+    if(pressedDelta != 0)
+    {
+        __atomic_fetch_add(pressedPins, (uint64_t)pressedDelta, __ATOMIC_RELAXED);
+    }
+}
+
+void DebouncerBank::
+AdvanceIndex()
+{
+    // Check to make sure the index hasn't gone over the limit
+    index++;
+    if(index >= NUM_BUTTON_STATES)
+    {
+        index = 0;
+    }
+
+    // Bring the upper levels of the summary up to date with the ports that
+    // were processed
+    Summarize(portSummary, numChunks, groupSummary);
+    Summarize(groupSummary, numGroupWords, rootSummary);
+}
+
+uint8_t DebouncerBank::
+ButtonPressed(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    return (changed[port] & debouncedState[port]) & GPIOButtonPins;
+}
+
+uint8_t DebouncerBank::
+ButtonReleased(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    return (changed[port] & (~debouncedState[port])) & GPIOButtonPins;
+}
+
+uint8_t DebouncerBank::
+ButtonCurrent(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    return debouncedState[port] & GPIOButtonPins;
+}
+
+uint32_t DebouncerBank::
+NumPorts() const
+{
+    return numPorts;
+}
+
+const uint8_t *DebouncerBank::
+DebouncedStates() const
+{
+    return debouncedState;
+}
+
+const uint8_t *DebouncerBank::
+ChangedStates() const
+{
+    return changed;
+}
+
+bool DebouncerBank::
+AnyChanged() const
+{
+    uint32_t word;
+
+    for(word = 0; word < numRootWords; word++)
+    {
+        if(rootSummary[word] != 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+uint32_t DebouncerBank::
+ChangedPortCount() const
+{
+    uint64_t bits;
+    uint32_t count = 0;
+    uint32_t word;
+    uint32_t group;
+
+    // Only the chunks that have changes are counted
+    for(word = 0; word < numGroupWords; word++)
+    {
+        bits = groupSummary[word];
+        while(bits != 0)
+        {
+            group = word * BUTTON_BANK_SUMMARY_BITS + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            count += __builtin_popcountll(portSummary[group]);
+        }
+    }
+
+    return count;
+}
+
+uint64_t DebouncerBank::
+PressedPinCount() const
+{
+    return __atomic_load_n(pressedPins, __ATOMIC_RELAXED);
+}
+
+//*********************************************************************************
+// Changed Iterator Functions
+//*********************************************************************************
+DebouncerBank::ChangedIterator::
+ChangedIterator(const DebouncerBank &bank, uint32_t firstPort)
+{
+    this->bank = &bank;
+
+    if(firstPort >= bank.numPorts)
+    {
+        rootWord = 0;
+        nextRootWord = bank.numRootWords;
+        rootBits = 0;
+        groupWord = 0;
+        groupBits = 0;
+        chunk = 0;
+        portBits = 0;
+        return;
+    }
+
+    // Start part way into the words that hold firstPort, leaving out
+    // everything before it
+    chunk = firstPort / BUTTON_BANK_ALIGNMENT;
+    groupWord = chunk / BUTTON_BANK_SUMMARY_BITS;
+    rootWord = groupWord / BUTTON_BANK_SUMMARY_BITS;
+    nextRootWord = rootWord + 1;
+
+    portBits = bank.portSummary[chunk] &
+               BitsFrom(firstPort % BUTTON_BANK_ALIGNMENT);
+    groupBits = bank.groupSummary[groupWord] &
+                BitsFrom(chunk % BUTTON_BANK_SUMMARY_BITS + 1);
+    rootBits = bank.rootSummary[rootWord] &
+               BitsFrom(groupWord % BUTTON_BANK_SUMMARY_BITS + 1);
+}
+
+bool DebouncerBank::ChangedIterator::
+Next(uint32_t &port)
+{
+    while(portBits == 0)
+    {
+        while(groupBits == 0)
+        {
+            while(rootBits == 0)
+            {
+                if(nextRootWord >= bank->numRootWords)
+                {
+                    return false;
+                }
+                rootWord = nextRootWord++;
+                rootBits = bank->rootSummary[rootWord];
+            }
+
+            groupWord = rootWord * BUTTON_BANK_SUMMARY_BITS + __builtin_ctzll(rootBits);
+            rootBits &= rootBits - 1;
+            groupBits = bank->groupSummary[groupWord];
+        }
+
+        chunk = groupWord * BUTTON_BANK_SUMMARY_BITS + __builtin_ctzll(groupBits);
+        groupBits &= groupBits - 1;
+        portBits = bank->portSummary[chunk];
+    }
+
+    port = chunk * BUTTON_BANK_ALIGNMENT + __builtin_ctzll(portBits);
+    portBits &= portBits - 1;
+
+    return true;
+}
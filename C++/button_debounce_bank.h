@@ -0,0 +1,493 @@
+//*********************************************************************************
+// State Button Debouncer - Debouncer Bank
+// 
+// Revision: 1.0
+// 
+// Description: Debounces a large number of 8 bit ports in one pass. Instead of
+// one Debouncer instantiation per port, a bank keeps the state of every port
+// in separate arrays (one array per field, one byte per port) so that the
+// debouncing of many ports can be done with wide loads and stores instead of
+// one function call per port. Every port in a bank behaves exactly like a
+// Debouncer instantiation that is given the same port statuses.
+// 
+// The bank either allocates its own storage or formats a block of storage
+// provided by the application, for example a shared memory segment.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_BANK_H
+#define BUTTON_DEBOUNCER_BANK_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stddef.h>
+#include <stdint.h>
+#include "button_debounce.h"
+#include "button_debounce_arena.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// Every per port array in a bank starts on a boundary of this many bytes and
+// is padded to a multiple of it. This is the size of a cache line on most
+// processors and is also the number of ports debounced together by the
+// bank's processing loop.
+#define BUTTON_BANK_ALIGNMENT   64
+
+// The number of bits in one word of the summary bitmaps
+#define BUTTON_BANK_SUMMARY_BITS    64
+
+// Options for the constructors taking storage or an arena
+#define BUTTON_BANK_DEFAULT         0x00
+
+// Every port uses the same pullups, kept once for the whole bank instead of
+// in the per port array. The array is only filled in if SetPullType,
+// ResetPort or MovePort later give ports pullups of their own.
+#define BUTTON_BANK_SHARED_PULL     0x01
+
+// The storage is known to be all zeros already, for example because it was
+// just mapped, so the bank doesn't have to clear it. Together with
+// BUTTON_BANK_SHARED_PULL the constructor then doesn't touch the storage at
+// all and the pages of ports that are never processed are never faulted in.
+#define BUTTON_BANK_ZEROED_STORAGE  0x02
+
+//*********************************************************************************
+// Class
+//*********************************************************************************
+
+class
+DebouncerBank
+{
+    public:
+        // 
+        // Storage Size
+        // Description:
+        //      Gets the amount of storage a bank of numPorts ports needs when
+        //      the storage is provided by the application.
+        // Parameters:
+        //      numPorts - The number of ports in the bank.
+        // Returns:
+        //      The number of bytes of storage required. The storage must be
+        //      aligned to BUTTON_BANK_ALIGNMENT bytes.
+        // 
+        static size_t StorageSize(uint32_t numPorts);
+
+        // 
+        // Constructor
+        // Description:
+        //      Initializes a bank of numPorts ports that owns its storage.
+        // Parameters:
+        //      numPorts - The number of ports in the bank.
+        //      pulledUpButtons - The pullups used on every port of the bank.
+        //          See the Debouncer constructor. SetPullType can change
+        //          this afterwards on a per port basis.
+        // Returns:
+        //      None
+        // 
+        DebouncerBank(uint32_t numPorts, uint8_t pulledUpButtons);
+
+        // 
+        // Constructor
+        // Description:
+        //      Initializes a bank of numPorts ports inside storage provided by
+        //      the application. The storage is formatted and must outlive the
+        //      bank.
+        // Parameters:
+        //      numPorts - The number of ports in the bank.
+        //      pulledUpButtons - The pullups used on every port of the bank.
+        //      storage - At least StorageSize(numPorts) bytes aligned to
+        //          BUTTON_BANK_ALIGNMENT bytes.
+        //      options - The ORed BUTTON_BANK_* options.
+        // Returns:
+        //      None
+        // 
+        DebouncerBank(uint32_t numPorts, uint8_t pulledUpButtons, void *storage,
+                      uint32_t options = BUTTON_BANK_DEFAULT);
+
+        // 
+        // Constructor
+        // Description:
+        //      Initializes a bank of numPorts ports whose storage is taken
+        //      from an arena, or from the heap if the arena has no room left.
+        // Parameters:
+        //      numPorts - The number of ports in the bank.
+        //      pulledUpButtons - The pullups used on every port of the bank.
+        //      arena - The arena, which must outlive the bank. A null
+        //          DebouncerArena pointer allocates from the heap.
+        //      options - The ORed BUTTON_BANK_* options. Storage taken from
+        //          an arena that maps its memory is always treated as
+        //          BUTTON_BANK_ZEROED_STORAGE.
+        // Returns:
+        //      None
+        // 
+        DebouncerBank(uint32_t numPorts, uint8_t pulledUpButtons, DebouncerArena *arena,
+                      uint32_t options = BUTTON_BANK_DEFAULT);
+
+        // 
+        // Constructor
+        // Description:
+        //      Attaches to storage that has already been formatted by another
+        //      bank of the same size, for example one living in another
+        //      process. The storage is left untouched. An attached bank should
+        //      only be queried.
+        // Parameters:
+        //      storage - The formatted storage.
+        //      numPorts - The number of ports in the bank.
+        // Returns:
+        //      None
+        // 
+        DebouncerBank(const void *storage, uint32_t numPorts);
+
+        ~DebouncerBank();
+
+        // 
+        // Set Pull Type
+        // Description:
+        //      Changes the pullups used on one port of the bank. On a bank
+        //      with BUTTON_BANK_SHARED_PULL, the first port given pullups
+        //      different from the shared ones fills in the per port array,
+        //      touching every port once.
+        // Parameters:
+        //      port - The port's index in the bank.
+        //      pulledUpButtons - See the Debouncer constructor.
+        // Returns:
+        //      None
+        // 
+        void SetPullType(uint32_t port, uint8_t pulledUpButtons);
+
+        // 
+        // Reset Port
+        // Description:
+        //      Puts one port back into the state of a newly constructed
+        //      Debouncer, for example when the port is reused for another
+        //      device. Should be called between ticks.
+        // Parameters:
+        //      port - The port's index in the bank.
+        //      pulledUpButtons - See the Debouncer constructor.
+        // Returns:
+        //      None
+        // 
+        void ResetPort(uint32_t port, uint8_t pulledUpButtons);
+
+        // 
+        // Move Port
+        // Description:
+        //      Copies the whole state of one port, history included, over
+        //      another port so that the port can carry on debouncing from its
+        //      new index. The state the destination port had is lost. Used to
+        //      keep the ports in use packed at the start of the bank. Should
+        //      be called between ticks.
+        // Parameters:
+        //      fromPort - The index of the port to copy.
+        //      toPort - The index of the port to overwrite.
+        // Returns:
+        //      None
+        // 
+        void MovePort(uint32_t fromPort, uint32_t toPort);
+
+        // 
+        // Button Process
+        // Description:
+        //      Debounces every port of the bank. This is the bank equivalent of
+        //      calling Debouncer::ButtonProcess on every port and should be
+        //      called on a regular interval by the application.
+        // Parameters:
+        //      portStatus - An array holding one status byte per port.
+        // Returns:
+        //      None
+        // 
+        void ButtonProcess(const uint8_t *portStatus);
+
+        // 
+        // Button Process Range
+        // Description:
+        //      Debounces a contiguous range of ports without moving on to the
+        //      next sample. Splitting one ButtonProcess call into several
+        //      ranges lets the work of one tick be spread out. Once every port
+        //      has been processed for the current tick, AdvanceIndex must be
+        //      called exactly once. Ranges that don't overlap and start and
+        //      end on multiples of BUTTON_BANK_ALIGNMENT ports never share a
+        //      cache line and may be processed by different threads.
+        // Parameters:
+        //      firstPort - The index of the first port in the range.
+        //      rangePorts - The number of ports in the range.
+        //      portStatus - One status byte per port in the range.
+        //          portStatus[0] belongs to firstPort.
+        // Returns:
+        //      None
+        // 
+        void ButtonProcessRange(uint32_t firstPort, uint32_t rangePorts,
+                                const uint8_t *portStatus);
+
+        // 
+        // Advance Index
+        // Description:
+        //      Finishes a tick that was processed with ButtonProcessRange.
+        // Parameters:
+        //      None
+        // Returns:
+        //      None
+        // 
+        void AdvanceIndex();
+
+        // 
+        // Button Pressed, Button Released and Button Current
+        // Description:
+        //      Same as the Debouncer functions of the same name for one port
+        //      of the bank.
+        // Parameters:
+        //      port - The port's index in the bank.
+        //      GPIOButtonPins - The ORed combination of BUTTON_PIN_*.
+        // Returns:
+        //      See the Debouncer functions of the same name.
+        // 
+        uint8_t ButtonPressed(uint32_t port, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonReleased(uint32_t port, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonCurrent(uint32_t port, uint8_t GPIOButtonPins) const;
+
+        // 
+        // Num Ports
+        // Description:
+        //      Gets the number of ports in the bank.
+        // Parameters:
+        //      None
+        // Returns:
+        //      The number of ports in the bank.
+        // 
+        uint32_t NumPorts() const;
+
+        // 
+        // Debounced States and Changed States
+        // Description:
+        //      Gives direct read access to the debounced state and changed
+        //      arrays of the bank for callers that scan many ports at once.
+        // Parameters:
+        //      None
+        // Returns:
+        //      An array holding one byte per port.
+        // 
+        const uint8_t *DebouncedStates() const;
+        const uint8_t *ChangedStates() const;
+
+        // 
+        // Any Changed
+        // Description:
+        //      Checks whether any port changed on the last tick without
+        //      looking at the ports themselves. Only the root of the summary
+        //      bitmaps is read, which is a single word for banks of up to
+        //      262144 ports.
+        // Parameters:
+        //      None
+        // Returns:
+        //      True if some port has pins that were just pressed or released.
+        // 
+        bool AnyChanged() const;
+
+        // 
+        // Changed Port Count
+        // Description:
+        //      Counts the ports that changed on the last tick.
+        // Parameters:
+        //      None
+        // Returns:
+        //      The number of ports with pins that were just pressed or
+        //      released.
+        // 
+        uint32_t ChangedPortCount() const;
+
+        // 
+        // Pressed Pin Count
+        // Description:
+        //      Gets the number of pins of the whole bank that are currently
+        //      debounced as pressed. The count is kept up to date as ports
+        //      change so this doesn't look at the ports.
+        // Parameters:
+        //      None
+        // Returns:
+        //      The number of pressed pins.
+        // 
+        uint64_t PressedPinCount() const;
+
+        // 
+        // Visits the ports that changed on the last tick in increasing order,
+        // skipping whole groups of ports without changes by way of the
+        // summary bitmaps:
+        // 
+        //      DebouncerBank::ChangedIterator it(bank, 0);
+        //      while(it.Next(port))
+        //      {
+        //          pressed = bank.ButtonPressed(port, 0xFF);
+        //          ...
+        //      }
+        // 
+        // The summaries are brought up to date by ButtonProcess and
+        // AdvanceIndex, so when a tick is processed with ButtonProcessRange
+        // the iterator only sees it once AdvanceIndex has been called.
+        // 
+        class
+        ChangedIterator
+        {
+            public:
+                // 
+                // Constructor
+                // Description:
+                //      Starts iterating at a port of the bank.
+                // Parameters:
+                //      bank - The bank.
+                //      firstPort - The first port that may be visited.
+                //          Normally 0.
+                // Returns:
+                //      None
+                // 
+                ChangedIterator(const DebouncerBank &bank, uint32_t firstPort);
+
+                // 
+                // Next
+                // Description:
+                //      Gets the next port that changed.
+                // Parameters:
+                //      port - Filled in with the port's index in the bank.
+                // Returns:
+                //      False once there are no more ports.
+                // 
+                bool Next(uint32_t &port);
+
+            private:
+                const DebouncerBank *bank;
+
+                // 
+                // The root word being walked and the next one to load
+                // 
+                uint32_t rootWord;
+                uint32_t nextRootWord;
+                uint64_t rootBits;
+
+                // 
+                // The group word being walked
+                // 
+                uint32_t groupWord;
+                uint64_t groupBits;
+
+                // 
+                // The 64 port chunk being walked
+                // 
+                uint32_t chunk;
+                uint64_t portBits;
+        };
+
+    private:
+        // 
+        // Banks are not copyable
+        // 
+        DebouncerBank(const DebouncerBank &);
+        DebouncerBank &operator=(const DebouncerBank &);
+
+        // 
+        // Points the arrays below into the storage
+        // 
+        void Layout(void *storage);
+
+        // 
+        // Sets every port to its initial state
+        // 
+        void Format(uint8_t pulledUpButtons, uint32_t options);
+
+        // 
+        // Makes a bank with shared pullups keep them per port
+        // 
+        void SplitPullType();
+
+        // 
+        // Brings the summary bitmaps up to date with one port's changed pins
+        // 
+        void SummarizePort(uint32_t port);
+
+        // 
+        // The storage allocated by the bank, if any
+        // 
+        uint8_t *ownedStorage;
+
+        // 
+        // The number of ports and the size of each per port array
+        // 
+        uint32_t numPorts;
+        uint32_t stride;
+
+        // 
+        // Keeps up with which state array gets the next port statuses
+        // 
+        uint8_t index;
+
+        // 
+        // NUM_BUTTON_STATES arrays of stride bytes holding the states that
+        // each port is transitioning through
+        // 
+        uint8_t *state;
+
+        // 
+        // The currently debounced state of the pins of each port
+        // 
+        uint8_t *debouncedState;
+
+        // 
+        // The pins of each port that just changed debounced state
+        // 
+        uint8_t *changed;
+
+        // 
+        // Pullups or pulldowns being used on each port. While sharedPull is
+        // set, the array isn't used and every port uses sharedPullType.
+        // 
+        uint8_t *pullType;
+        uint8_t sharedPullType;
+        bool sharedPull;
+
+        // 
+        // The number of pins currently debounced as pressed
+        // 
+        uint64_t *pressedPins;
+
+        // 
+        // Summary bitmaps of the changed array. portSummary has one bit per
+        // port that changed, one word per BUTTON_BANK_ALIGNMENT ports.
+        // groupSummary has one bit per non zero word of portSummary and
+        // rootSummary has one bit per non zero word of groupSummary.
+        // 
+        uint64_t *portSummary;
+        uint64_t *groupSummary;
+        uint64_t *rootSummary;
+        uint32_t numChunks;
+        uint32_t numGroupWords;
+        uint32_t numRootWords;
+};
+
+#endif  // BUTTON_DEBOUNCER_BANK_H
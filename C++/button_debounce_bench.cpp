@@ -0,0 +1,309 @@
+//*********************************************************************************
+// Button Debouncer Allocation Benchmark
+// 
+// Description:
+// Times a very large DebouncerBank allocated from the heap and from arenas
+// that map their memory with the different BUTTON_ARENA_MAP_* options. Each
+// run times ButtonProcess over every port and ButtonCurrent on randomly chosen
+// ports. The random queries are where huge pages help most, since nearly
+// every query touches a page the TLB doesn't know about. The last run builds
+// the bank with BUTTON_BANK_SHARED_PULL in a mapped arena, which leaves the
+// pages untouched until the first tick.
+// 
+// The placement runs pin the benchmark to the CPUs of one NUMA node and time
+// a bank on that node and then a bank on another node, the way a shard of a
+// partitioned bank is processed by a thread on its own node or a thread
+// elsewhere. They need a machine with more than one node.
+// 
+// Compile and run on Linux with:
+//      g++ -O2 -std=c++11 button_debounce_bench.cpp button_debounce.cpp
+//          button_debounce_bank.cpp button_debounce_arena.cpp
+//          -o button_debounce_bench
+//      ./button_debounce_bench [ports] [ticks] [NUMA node]
+// 
+// Explicit huge pages have to be reserved first, for example with
+//      echo 2048 > /proc/sys/vm/nr_hugepages
+// Otherwise the HUGETLB run falls back to transparent huge pages, which the
+// output shows.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#endif
+#include "button_debounce_arena.h"
+#include "button_debounce_bank.h"
+
+// The number of random queries timed per run
+#define BENCH_QUERIES           (16 * 1024 * 1024)
+
+// Keeps the compiler from dropping the queries
+static volatile uint32_t querySink;
+
+// The most NUMA nodes looked for
+#define BENCH_MAX_NODES         64
+
+static double
+Now()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static uint32_t
+NextRandom(uint32_t &seed)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    return seed;
+}
+
+// 
+// Counts the NUMA nodes the system has, or gives 0 where that isn't known
+// 
+static int
+NumNodes()
+{
+    int nodes = 0;
+#if defined(__linux__)
+    char path[64];
+    int node;
+
+    for(node = 0; node < BENCH_MAX_NODES; node++)
+    {
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d", node);
+        if(access(path, F_OK) == 0)
+        {
+            nodes = node + 1;
+        }
+    }
+#endif
+
+    return nodes;
+}
+
+// 
+// Restricts the calling thread to the CPUs of one NUMA node
+// 
+static bool
+PinToNode(int node)
+{
+#if defined(__linux__)
+    char path[64];
+    char list[1024];
+    char *next;
+    cpu_set_t cpus;
+    unsigned long first;
+    unsigned long last;
+    unsigned long cpu;
+    FILE *file;
+
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+    file = fopen(path, "r");
+    if(file == NULL)
+    {
+        return false;
+    }
+    if(fgets(list, sizeof(list), file) == NULL)
+    {
+        list[0] = '\0';
+    }
+    fclose(file);
+
+    // The list looks like "0-3,8-11"
+    CPU_ZERO(&cpus);
+    next = list;
+    while(*next >= '0' && *next <= '9')
+    {
+        first = strtoul(next, &next, 10);
+        last = first;
+        if(*next == '-')
+        {
+            last = strtoul(next + 1, &next, 10);
+        }
+        for(cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+        {
+            CPU_SET(cpu, &cpus);
+        }
+        if(*next == ',')
+        {
+            next++;
+        }
+    }
+
+    return CPU_COUNT(&cpus) != 0 && sched_setaffinity(0, sizeof(cpus), &cpus) == 0;
+#else
+    (void)node;
+    return false;
+#endif
+}
+
+static void
+Run(const char *name, DebouncerArena *arena, uint32_t options, uint32_t numPorts,
+    uint32_t ticks, uint8_t *portStatus)
+{
+    DebouncerBank *bank;
+    double start;
+    double setup;
+    double process;
+    double query;
+    uint32_t seed = 12345;
+    uint32_t pins = 0;
+    uint32_t tick;
+    uint32_t i;
+
+    start = Now();
+    bank = new DebouncerBank(numPorts, 0x00, arena, options);
+    setup = Now() - start;
+
+    start = Now();
+    for(tick = 0; tick < ticks; tick++)
+    {
+        // Move a few buttons every tick so there is something to debounce
+        for(i = 0; i < 64; i++)
+        {
+            portStatus[NextRandom(seed) % numPorts] ^= (uint8_t)(1 << (tick & 7));
+        }
+
+        bank->ButtonProcess(portStatus);
+    }
+    process = Now() - start;
+
+    start = Now();
+    for(i = 0; i < BENCH_QUERIES; i++)
+    {
+        pins += bank->ButtonCurrent(NextRandom(seed) % numPorts, 0xFF);
+    }
+    query = Now() - start;
+
+    querySink = pins;
+
+    printf("%-12s %-9s %10.1f %12.3f %12.2f\n", name,
+           arena == NULL ? "-" :
+           arena->HugePages() == BUTTON_ARENA_MAP_HUGETLB ? "hugetlb" :
+           arena->HugePages() == BUTTON_ARENA_MAP_THP ? "thp" : "4k",
+           setup * 1e3, process * 1e9 / ((double)ticks * numPorts),
+           query * 1e9 / BENCH_QUERIES);
+
+    delete bank;
+}
+
+int
+main(int argc, char **argv)
+{
+    uint32_t numPorts = 32 * 1024 * 1024;
+    uint32_t ticks = 20;
+    int numaNode = BUTTON_ARENA_ANY_NODE;
+    int localNode;
+    int remoteNode;
+    int numNodes = NumNodes();
+    char name[32];
+    uint8_t *portStatus;
+    size_t size;
+    DebouncerArena *arena;
+
+    if(argc > 1)
+    {
+        numPorts = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    if(argc > 2)
+    {
+        ticks = (uint32_t)strtoul(argv[2], NULL, 0);
+    }
+    if(argc > 3)
+    {
+        numaNode = atoi(argv[3]);
+    }
+
+    if(numPorts == 0 || ticks == 0)
+    {
+        fprintf(stderr, "usage: %s [ports] [ticks] [NUMA node]\n", argv[0]);
+        return 1;
+    }
+
+    portStatus = new uint8_t[numPorts];
+    memset(portStatus, 0, numPorts);
+    size = DebouncerBank::StorageSize(numPorts) + BUTTON_BANK_ALIGNMENT;
+
+    printf("%u ports, %u ticks, %.1f MB of bank state\n", numPorts, ticks,
+           size / (1024.0 * 1024.0));
+    printf("%-12s %-9s %10s %12s %12s\n", "memory", "pages", "setup ms",
+           "ns/port", "ns/query");
+
+    Run("heap", NULL, BUTTON_BANK_DEFAULT, numPorts, ticks, portStatus);
+
+    arena = new DebouncerArena(size, BUTTON_ARENA_MAP_DEFAULT, numaNode);
+    Run("mapped", arena, BUTTON_BANK_DEFAULT, numPorts, ticks, portStatus);
+    delete arena;
+
+    arena = new DebouncerArena(size, BUTTON_ARENA_MAP_THP, numaNode);
+    Run("thp", arena, BUTTON_BANK_DEFAULT, numPorts, ticks, portStatus);
+    delete arena;
+
+    arena = new DebouncerArena(size, BUTTON_ARENA_MAP_HUGETLB, numaNode);
+    Run("hugetlb", arena, BUTTON_BANK_DEFAULT, numPorts, ticks, portStatus);
+    delete arena;
+
+    arena = new DebouncerArena(size, BUTTON_ARENA_MAP_THP, numaNode);
+    Run("thp shared", arena, BUTTON_BANK_SHARED_PULL, numPorts, ticks, portStatus);
+    delete arena;
+
+    // Process a bank on the node the benchmark runs on, then one on the
+    // next node over
+    localNode = numaNode >= 0 ? numaNode : 0;
+    remoteNode = numNodes > 1 ? (localNode + 1) % numNodes : -1;
+    if(remoteNode < 0 || !PinToNode(localNode))
+    {
+        printf("placement runs skipped: needs more than one NUMA node\n");
+    }
+    else
+    {
+        snprintf(name, sizeof(name), "node %d>%d", localNode, localNode);
+        arena = new DebouncerArena(size, BUTTON_ARENA_MAP_THP, localNode);
+        Run(name, arena, BUTTON_BANK_DEFAULT, numPorts, ticks, portStatus);
+        delete arena;
+
+        snprintf(name, sizeof(name), "node %d>%d", localNode, remoteNode);
+        arena = new DebouncerArena(size, BUTTON_ARENA_MAP_THP, remoteNode);
+        Run(name, arena, BUTTON_BANK_DEFAULT, numPorts, ticks, portStatus);
+        delete arena;
+    }
+
+    delete[] portStatus;
+
+    return 0;
+}
@@ -0,0 +1,309 @@
+//*********************************************************************************
+// State Button Debouncer - Broadcast Event Ring
+// 
+// Revision: 1.0
+// 
+// Description: Hands button events to any number of consumers. See
+// button_debounce_broadcast.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include "button_debounce_broadcast.h"
+
+//*********************************************************************************
+// Local Functions
+//*********************************************************************************
+
+// 
+// An event is kept in a slot as one 64 bit word so that it can be read and
+// written atomically: the port in the low 32 bits followed by the pressed
+// and released pins.
+// 
+static uint64_t
+PackEvent(uint32_t port, uint8_t pressed, uint8_t released)
+{
+    return (uint64_t)port | ((uint64_t)pressed << 32) | ((uint64_t)released << 40);
+}
+
+//*********************************************************************************
+// Ring Functions
+//*********************************************************************************
+DebouncerEventRing::
+DebouncerEventRing(uint32_t capacity, uint8_t fullPolicy, DebouncerArena *arena)
+{
+    uint32_t i;
+
+    this->arena = arena;
+    slots = DebouncerAllocate<Slot>(arena, capacity);
+    mask = capacity - 1;
+    policy = fullPolicy;
+    head.store(0, std::memory_order_relaxed);
+    slowestCursor = 0;
+
+    for(i = 0; i < capacity; i++)
+    {
+        slots[i].sequence.store(0, std::memory_order_relaxed);
+        slots[i].payload.store(0, std::memory_order_relaxed);
+    }
+
+    for(i = 0; i < BUTTON_BROADCAST_MAX_CONSUMERS; i++)
+    {
+        cursors[i].position.store(0, std::memory_order_relaxed);
+        cursors[i].attached.store(false, std::memory_order_relaxed);
+    }
+}
+
+DebouncerEventRing::
+~DebouncerEventRing()
+{
+    DebouncerFree(arena, slots, (size_t)mask + 1);
+}
+
+uint64_t DebouncerEventRing::
+SlowestCursor() const
+{
+    uint64_t slowest = head.load(std::memory_order_relaxed);
+    uint64_t position;
+    uint32_t i;
+
+    for(i = 0; i < BUTTON_BROADCAST_MAX_CONSUMERS; i++)
+    {
+        if(cursors[i].attached.load(std::memory_order_seq_cst))
+        {
+            position = cursors[i].position.load(std::memory_order_acquire);
+            if(position < slowest)
+            {
+                slowest = position;
+            }
+        }
+    }
+
+    return slowest;
+}
+
+bool DebouncerEventRing::
+Publish(uint32_t port, uint8_t pressed, uint8_t released)
+{
+    uint64_t position = head.load(std::memory_order_relaxed);
+    Slot *slot = &slots[position & mask];
+
+    if((pressed | released) == 0)
+    {
+        return true;
+    }
+
+    // Writing this event would overwrite the event at position - capacity.
+    // Only look at the consumers again when the last known slowest cursor
+    // says that event may not have been read yet.
+    if(policy == BUTTON_BROADCAST_THROTTLE && position - slowestCursor > mask)
+    {
+        slowestCursor = SlowestCursor();
+        if(position - slowestCursor > mask)
+        {
+            return false;
+        }
+    }
+
+    // Mark the slot as being written, write the event and then mark it as
+    // holding the event at this position
+    slot->sequence.store(2 * position + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->payload.store(PackEvent(port, pressed, released), std::memory_order_relaxed);
+    slot->sequence.store(2 * position + 2, std::memory_order_release);
+
+    head.store(position + 1, std::memory_order_release);
+
+    return true;
+}
+
+bool DebouncerEventRing::
+Publish(uint32_t port, Debouncer &debouncer)
+{
+    return Publish(port, debouncer.ButtonPressed(0xFF),
+                   debouncer.ButtonReleased(0xFF));
+}
+
+uint32_t DebouncerEventRing::
+Publish(const DebouncerBank &bank, uint32_t firstPort, uint32_t portOffset)
+{
+    const uint8_t *changed = bank.ChangedStates();
+    const uint8_t *debounced = bank.DebouncedStates();
+    DebouncerBank::ChangedIterator it(bank, firstPort);
+    uint32_t port;
+
+    while(it.Next(port))
+    {
+        if(!Publish(port + portOffset, changed[port] & debounced[port],
+                    changed[port] & ~debounced[port]))
+        {
+            return port;
+        }
+    }
+
+    return bank.NumPorts();
+}
+
+uint64_t DebouncerEventRing::
+Published() const
+{
+    return head.load(std::memory_order_acquire);
+}
+
+//*********************************************************************************
+// Consumer Functions
+//*********************************************************************************
+DebouncerEventConsumer::
+DebouncerEventConsumer()
+{
+    ring = NULL;
+    cursor = NULL;
+    position = 0;
+    lost = 0;
+    pins = 0;
+}
+
+DebouncerEventConsumer::
+~DebouncerEventConsumer()
+{
+    Detach();
+}
+
+bool DebouncerEventConsumer::
+Attach(DebouncerEventRing &eventRing, uint8_t subscribedPins)
+{
+    bool expected;
+    uint32_t i;
+
+    Detach();
+
+    for(i = 0; i < BUTTON_BROADCAST_MAX_CONSUMERS; i++)
+    {
+        expected = false;
+        if(eventRing.cursors[i].attached.compare_exchange_strong(expected, true))
+        {
+            ring = &eventRing;
+            cursor = &eventRing.cursors[i];
+            pins = subscribedPins;
+            lost = 0;
+
+            // Start at the producer's current position. The cursor is
+            // published only after claiming the slot above so the producer
+            // can never have lapped it by the time it becomes visible.
+            position = ring->head.load(std::memory_order_acquire);
+            cursor->position.store(position, std::memory_order_seq_cst);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void DebouncerEventConsumer::
+Detach()
+{
+    if(cursor != NULL)
+    {
+        cursor->attached.store(false, std::memory_order_release);
+        cursor = NULL;
+        ring = NULL;
+    }
+}
+
+bool DebouncerEventConsumer::
+Poll(DebouncerEvent &event)
+{
+    DebouncerEventRing::Slot *slot;
+    uint64_t sequence;
+    uint64_t payload;
+    uint64_t oldest;
+    uint8_t pressed;
+    uint8_t released;
+
+    if(ring == NULL)
+    {
+        return false;
+    }
+
+    while(1)
+    {
+        slot = &ring->slots[position & ring->mask];
+        sequence = slot->sequence.load(std::memory_order_acquire);
+
+        // Nothing new yet, or the producer is in the middle of writing it
+        if(sequence < 2 * position + 2)
+        {
+            return false;
+        }
+
+        if(sequence == 2 * position + 2)
+        {
+            payload = slot->payload.load(std::memory_order_relaxed);
+
+            // Make sure the producer didn't start overwriting the slot
+            // while it was being read
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(slot->sequence.load(std::memory_order_relaxed) == sequence)
+            {
+                position++;
+                cursor->position.store(position, std::memory_order_release);
+
+                pressed = (uint8_t)(payload >> 32) & pins;
+                released = (uint8_t)(payload >> 40) & pins;
+                if((pressed | released) != 0)
+                {
+                    event.sequence = position - 1;
+                    event.port = (uint32_t)payload;
+                    event.pressed = pressed;
+                    event.released = released;
+                    return true;
+                }
+
+                continue;
+            }
+        }
+
+        // The producer has lapped this consumer. Skip ahead to the oldest
+        // event that is still in the ring and remember what was missed.
+        oldest = ring->head.load(std::memory_order_acquire) - (ring->mask + 1);
+        if(oldest > position)
+        {
+            lost += oldest - position;
+            position = oldest;
+            cursor->position.store(position, std::memory_order_release);
+        }
+    }
+}
+
+uint64_t DebouncerEventConsumer::
+Lost() const
+{
+    return lost;
+}
@@ -0,0 +1,291 @@
+//*********************************************************************************
+// State Button Debouncer - Broadcast Event Ring
+// 
+// Revision: 1.0
+// 
+// Description: Hands the button presses and releases found by a Debouncer or a
+// DebouncerBank to any number of consumers. Each event is written into the
+// ring once and every consumer reads it from there at its own pace by keeping
+// its own position (cursor) in the ring. A consumer can also ask for only the
+// events of certain pins.
+// 
+// The ring has a fixed size. When the slowest consumer falls a whole ring
+// behind, the ring either refuses new events until that consumer catches up
+// (BUTTON_BROADCAST_THROTTLE) or overwrites the oldest events
+// (BUTTON_BROADCAST_OVERWRITE). In the second case the consumer that fell
+// behind is told how many events it missed.
+// 
+// Only one thread may publish events. Each consumer must only be used by one
+// thread at a time. Requires C++11.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_BROADCAST_H
+#define BUTTON_DEBOUNCER_BROADCAST_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include <atomic>
+#include "button_debounce.h"
+#include "button_debounce_bank.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// The most consumers that can be attached to one ring at the same time
+#define BUTTON_BROADCAST_MAX_CONSUMERS  16
+
+// What the ring does when it is full
+#define BUTTON_BROADCAST_OVERWRITE      0
+#define BUTTON_BROADCAST_THROTTLE       1
+
+// 
+// One event as seen by a consumer
+// 
+struct
+DebouncerEvent
+{
+    // 
+    // The event's position in the ring. Counts up by one for every event
+    // published, so a consumer can tell events apart and notice gaps.
+    // 
+    uint64_t sequence;
+
+    // 
+    // The port the event happened on as given to Publish
+    // 
+    uint32_t port;
+
+    // 
+    // The pins that were just pressed and just released, already masked
+    // with the consumer's subscribed pins
+    // 
+    uint8_t pressed;
+    uint8_t released;
+};
+
+//*********************************************************************************
+// Classes
+//*********************************************************************************
+
+class DebouncerEventConsumer;
+
+class
+DebouncerEventRing
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Initializes an empty ring.
+        // Parameters:
+        //      capacity - The number of events the ring holds. Must be a power
+        //          of two.
+        //      fullPolicy - BUTTON_BROADCAST_OVERWRITE or
+        //          BUTTON_BROADCAST_THROTTLE.
+        //      arena - Where to allocate the ring from, or NULL for the
+        //          heap.
+        // Returns:
+        //      None
+        // 
+        DebouncerEventRing(uint32_t capacity, uint8_t fullPolicy,
+                           DebouncerArena *arena = NULL);
+        ~DebouncerEventRing();
+
+        // 
+        // Publish
+        // Description:
+        //      Writes one event into the ring. Nothing is written if both
+        //      pressed and released are 0.
+        // Parameters:
+        //      port - The port the event happened on.
+        //      pressed - The pins that were just pressed.
+        //      released - The pins that were just released.
+        // Returns:
+        //      False if the ring throttles and is full. The event should be
+        //      published again later. True otherwise.
+        // 
+        bool Publish(uint32_t port, uint8_t pressed, uint8_t released);
+
+        // 
+        // Publish
+        // Description:
+        //      Writes the events that the last ButtonProcess call on a
+        //      Debouncer produced.
+        // Parameters:
+        //      port - The number consumers will see for this Debouncer.
+        //      debouncer - The Debouncer instantiation.
+        // Returns:
+        //      See above.
+        // 
+        bool Publish(uint32_t port, Debouncer &debouncer);
+
+        // 
+        // Publish
+        // Description:
+        //      Writes the events that the last ButtonProcess call on a bank
+        //      produced, one event per port that has any. Ports are numbered
+        //      as in the bank plus portOffset.
+        // Parameters:
+        //      bank - The bank.
+        //      firstPort - The bank port to start at. Normally 0.
+        //      portOffset - Added to every port number consumers see.
+        // Returns:
+        //      The bank port where publishing stopped because the ring
+        //      throttled, or bank.NumPorts() if every event was written. Call
+        //      again later starting from the returned port to finish.
+        // 
+        uint32_t Publish(const DebouncerBank &bank, uint32_t firstPort,
+                         uint32_t portOffset);
+
+        // 
+        // Published
+        // Description:
+        //      Gets the number of events published so far.
+        // 
+        uint64_t Published() const;
+
+    private:
+        friend class DebouncerEventConsumer;
+
+        DebouncerEventRing(const DebouncerEventRing &);
+        DebouncerEventRing &operator=(const DebouncerEventRing &);
+
+        // 
+        // Finds the slowest attached consumer
+        // 
+        uint64_t SlowestCursor() const;
+
+        // 
+        // An event slot. The sequence is odd while the slot is being written
+        // and 2 * (position + 1) once the event at position is complete.
+        // 
+        struct
+        Slot
+        {
+            std::atomic<uint64_t> sequence;
+            std::atomic<uint64_t> payload;
+        };
+
+        // 
+        // A consumer's cursor, on a cache line of its own so that consumers
+        // moving their cursors don't slow each other down
+        // 
+        struct alignas(BUTTON_BANK_ALIGNMENT)
+        Cursor
+        {
+            std::atomic<uint64_t> position;
+            std::atomic<bool> attached;
+        };
+
+        // 
+        // The producer's position, only written by the producer
+        // 
+        alignas(BUTTON_BANK_ALIGNMENT) std::atomic<uint64_t> head;
+
+        // 
+        // The slowest consumer's cursor the last time the producer looked.
+        // Only used when throttling and only touched by the producer.
+        // 
+        uint64_t slowestCursor;
+
+        Slot *slots;
+        DebouncerArena *arena;
+        uint32_t mask;
+        uint8_t policy;
+
+        Cursor cursors[BUTTON_BROADCAST_MAX_CONSUMERS];
+};
+
+class
+DebouncerEventConsumer
+{
+    public:
+        DebouncerEventConsumer();
+        ~DebouncerEventConsumer();
+
+        // 
+        // Attach
+        // Description:
+        //      Starts consuming the events of a ring. Only events published
+        //      after this call are seen.
+        // Parameters:
+        //      eventRing - The ring to consume.
+        //      subscribedPins - The ORed BUTTON_PIN_* this consumer wants
+        //          events for. Events on other pins are skipped.
+        // Returns:
+        //      False if the ring already has BUTTON_BROADCAST_MAX_CONSUMERS
+        //      consumers.
+        // 
+        bool Attach(DebouncerEventRing &eventRing, uint8_t subscribedPins);
+
+        // 
+        // Detach
+        // Description:
+        //      Stops consuming. A throttling ring no longer waits for this
+        //      consumer. Called by the destructor.
+        // 
+        void Detach();
+
+        // 
+        // Poll
+        // Description:
+        //      Gets the next event on the subscribed pins.
+        // Parameters:
+        //      event - Filled in with the event.
+        // Returns:
+        //      True if there was an event. False if the consumer has caught
+        //      up with the producer or isn't attached to a ring.
+        // 
+        bool Poll(DebouncerEvent &event);
+
+        // 
+        // Lost
+        // Description:
+        //      Gets the number of events that were overwritten before this
+        //      consumer got to them. Always 0 for a throttling ring.
+        // 
+        uint64_t Lost() const;
+
+    private:
+        DebouncerEventConsumer(const DebouncerEventConsumer &);
+        DebouncerEventConsumer &operator=(const DebouncerEventConsumer &);
+
+        DebouncerEventRing *ring;
+        DebouncerEventRing::Cursor *cursor;
+        uint64_t position;
+        uint64_t lost;
+        uint8_t pins;
+};
+
+#endif  // BUTTON_DEBOUNCER_BROADCAST_H
@@ -0,0 +1,259 @@
+//*********************************************************************************
+// State Button Debouncer - Coroutine Awaitables
+// 
+// Revision: 1.0
+// 
+// Description: Lets C++20 coroutines co_await button presses and releases. See
+// button_debounce_coro.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stddef.h>
+#include "button_debounce_coro.h"
+
+//*********************************************************************************
+// Awaiter Functions
+//*********************************************************************************
+DebouncerAwaiter::
+DebouncerAwaiter(DebouncerAwaitPort *port, uint8_t GPIOButtonPins, uint8_t edge)
+{
+    this->port = port;
+    this->edge = edge;
+    pins = GPIOButtonPins;
+    result = 0;
+    waiting = false;
+    nextReady = NULL;
+}
+
+DebouncerAwaiter::
+~DebouncerAwaiter()
+{
+    if(waiting)
+    {
+        port->Unlink(this);
+    }
+}
+
+bool DebouncerAwaiter::
+await_ready() const noexcept
+{
+    // Waiting on no pins at all would never finish
+    return pins == 0;
+}
+
+void DebouncerAwaiter::
+await_suspend(std::coroutine_handle<> handle)
+{
+    this->handle = handle;
+    port->Link(this);
+}
+
+uint8_t DebouncerAwaiter::
+await_resume() const noexcept
+{
+    return result;
+}
+
+//*********************************************************************************
+// Port Functions
+//*********************************************************************************
+DebouncerAwaitPort::
+DebouncerAwaitPort(uint8_t pulledUpButtons) : debouncer(pulledUpButtons)
+{
+    uint8_t i;
+
+    for(i = 0; i < 8; i++)
+    {
+        waiters[BUTTON_AWAIT_PRESSED][i] = NULL;
+        waiters[BUTTON_AWAIT_RELEASED][i] = NULL;
+    }
+
+    resumeHook = NULL;
+    resumeContext = NULL;
+}
+
+void DebouncerAwaitPort::
+Link(DebouncerAwaiter *awaiter)
+{
+    DebouncerAwaiter **head;
+    uint8_t i;
+
+    for(i = 0; i < 8; i++)
+    {
+        if(awaiter->pins & (1 << i))
+        {
+            head = &waiters[awaiter->edge][i];
+
+            awaiter->links[i].previous = NULL;
+            awaiter->links[i].next = *head;
+            if(*head != NULL)
+            {
+                (*head)->links[i].previous = awaiter;
+            }
+            *head = awaiter;
+        }
+    }
+
+    awaiter->waiting = true;
+}
+
+void DebouncerAwaitPort::
+Unlink(DebouncerAwaiter *awaiter)
+{
+    DebouncerAwaiter::Link *link;
+    uint8_t i;
+
+    for(i = 0; i < 8; i++)
+    {
+        if(awaiter->pins & (1 << i))
+        {
+            link = &awaiter->links[i];
+
+            if(link->previous != NULL)
+            {
+                link->previous->links[i].next = link->next;
+            }
+            else
+            {
+                waiters[awaiter->edge][i] = link->next;
+            }
+
+            if(link->next != NULL)
+            {
+                link->next->links[i].previous = link->previous;
+            }
+        }
+    }
+
+    awaiter->waiting = false;
+}
+
+void DebouncerAwaitPort::
+ButtonProcess(uint8_t portStatus)
+{
+    DebouncerAwaiter *ready = NULL;
+    DebouncerAwaiter *awaiter;
+    uint8_t edges[2];
+    uint8_t edge;
+    uint8_t i;
+
+    debouncer.ButtonProcess(portStatus);
+
+    edges[BUTTON_AWAIT_PRESSED] = debouncer.ButtonPressed(0xFF);
+    edges[BUTTON_AWAIT_RELEASED] = debouncer.ButtonReleased(0xFF);
+    if((edges[BUTTON_AWAIT_PRESSED] | edges[BUTTON_AWAIT_RELEASED]) == 0)
+    {
+        return;
+    }
+
+    // Gather every awaiter waiting on a pin that just changed. An awaiter
+    // waiting on several pins that changed together is only gathered once
+    // but is told about all of them.
+    for(edge = 0; edge < 2; edge++)
+    {
+        for(i = 0; i < 8; i++)
+        {
+            if(!(edges[edge] & (1 << i)))
+            {
+                continue;
+            }
+
+            for(awaiter = waiters[edge][i]; awaiter != NULL;
+                awaiter = awaiter->links[i].next)
+            {
+                if(awaiter->result == 0)
+                {
+                    awaiter->nextReady = ready;
+                    ready = awaiter;
+                }
+                awaiter->result |= (1 << i);
+            }
+        }
+    }
+
+    // Take them all off the lists before resuming any of them. A resumed
+    // coroutine may well co_await on this port again right away.
+    for(awaiter = ready; awaiter != NULL; awaiter = awaiter->nextReady)
+    {
+        Unlink(awaiter);
+    }
+
+    while(ready != NULL)
+    {
+        awaiter = ready;
+        ready = ready->nextReady;
+
+        if(resumeHook != NULL)
+        {
+            resumeHook(awaiter->handle, resumeContext);
+        }
+        else
+        {
+            awaiter->handle.resume();
+        }
+    }
+}
+
+DebouncerAwaiter DebouncerAwaitPort::
+Pressed(uint8_t GPIOButtonPins)
+{
+    return DebouncerAwaiter(this, GPIOButtonPins, BUTTON_AWAIT_PRESSED);
+}
+
+DebouncerAwaiter DebouncerAwaitPort::
+Released(uint8_t GPIOButtonPins)
+{
+    return DebouncerAwaiter(this, GPIOButtonPins, BUTTON_AWAIT_RELEASED);
+}
+
+void DebouncerAwaitPort::
+SetResumeHook(DebouncerResumeHook hook, void *context)
+{
+    resumeHook = hook;
+    resumeContext = context;
+}
+
+uint8_t DebouncerAwaitPort::
+ButtonPressed(uint8_t GPIOButtonPins)
+{
+    return debouncer.ButtonPressed(GPIOButtonPins);
+}
+
+uint8_t DebouncerAwaitPort::
+ButtonReleased(uint8_t GPIOButtonPins)
+{
+    return debouncer.ButtonReleased(GPIOButtonPins);
+}
+
+uint8_t DebouncerAwaitPort::
+ButtonCurrent(uint8_t GPIOButtonPins)
+{
+    return debouncer.ButtonCurrent(GPIOButtonPins);
+}
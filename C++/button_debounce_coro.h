@@ -0,0 +1,237 @@
+//*********************************************************************************
+// State Button Debouncer - Coroutine Awaitables
+// 
+// Revision: 1.0
+// 
+// Description: Lets C++20 coroutines wait for button presses and releases with
+// co_await instead of polling ButtonPressed on every tick:
+// 
+//      DebouncerAwaitPort port1(BUTTON_PIN_2);
+// 
+//      Task
+//      LedTask()
+//      {
+//          while(1)
+//          {
+//              co_await port1.Pressed(BUTTON_PIN_2 | BUTTON_PIN_3);
+//              // Toggle the LED on or off
+//          }
+//      }
+// 
+//      // Every millisecond
+//      port1.ButtonProcess(Port1ReadBits());
+// 
+// A suspended coroutine is kept on a list for each pin it waits for, and
+// ButtonProcess only looks at the lists of pins that just changed. Coroutines
+// waiting on pins that didn't change cost nothing. By default a coroutine is
+// resumed from inside ButtonProcess. A resume hook can hand it to a scheduler
+// instead.
+// 
+// The coroutine type (Task above) is up to the application; any coroutine can
+// co_await these awaitables. A port and the coroutines waiting on it must all
+// be used from the same thread. Requires C++20.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_CORO_H
+#define BUTTON_DEBOUNCER_CORO_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include <coroutine>
+#include "button_debounce.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// What an awaitable waits for
+#define BUTTON_AWAIT_PRESSED    0
+#define BUTTON_AWAIT_RELEASED   1
+
+// 
+// Called instead of resuming a coroutine directly when set with
+// SetResumeHook. The hook must resume the handle at some point, for example by
+// queueing it on the application's scheduler.
+// 
+typedef void (*DebouncerResumeHook)(std::coroutine_handle<> handle, void *context);
+
+//*********************************************************************************
+// Classes
+//*********************************************************************************
+
+class DebouncerAwaitPort;
+
+class
+DebouncerAwaiter
+{
+    public:
+        DebouncerAwaiter(DebouncerAwaitPort *port, uint8_t GPIOButtonPins,
+                         uint8_t edge);
+
+        // 
+        // Destructor
+        // Description:
+        //      Takes a coroutine that is destroyed while suspended off the
+        //      port's lists.
+        // 
+        ~DebouncerAwaiter();
+
+        DebouncerAwaiter(const DebouncerAwaiter &) = delete;
+        DebouncerAwaiter &operator=(const DebouncerAwaiter &) = delete;
+
+        // 
+        // The awaitable interface used by co_await
+        // 
+        bool await_ready() const noexcept;
+        void await_suspend(std::coroutine_handle<> handle);
+        uint8_t await_resume() const noexcept;
+
+    private:
+        friend class DebouncerAwaitPort;
+
+        // 
+        // Links the awaiter into the list of one pin
+        // 
+        struct
+        Link
+        {
+            DebouncerAwaiter *previous;
+            DebouncerAwaiter *next;
+        };
+
+        DebouncerAwaitPort *port;
+        std::coroutine_handle<> handle;
+        Link links[8];
+
+        // 
+        // Links the awaiters resumed by one ButtonProcess call
+        // 
+        DebouncerAwaiter *nextReady;
+
+        uint8_t pins;
+        uint8_t edge;
+        uint8_t result;
+        bool waiting;
+};
+
+class
+DebouncerAwaitPort
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Initializes the port's Debouncer. See the Debouncer
+        //      constructor.
+        // 
+        DebouncerAwaitPort(uint8_t pulledUpButtons);
+
+        // 
+        // Button Process
+        // Description:
+        //      Same as Debouncer::ButtonProcess. Afterwards resumes the
+        //      coroutines waiting for an edge on one of the pins that just
+        //      changed.
+        // Parameters:
+        //      portStatus - The particular port's status expressed as one 8 bit
+        //          byte.
+        // Returns:
+        //      None
+        // 
+        void ButtonProcess(uint8_t portStatus);
+
+        // 
+        // Pressed and Released
+        // Description:
+        //      Gets something to co_await on until one of the pins is pressed
+        //      or released. The co_await expression gives the pins that were
+        //      pressed or released by the ButtonProcess call that resumed the
+        //      coroutine.
+        // Parameters:
+        //      GPIOButtonPins - The ORed combination of BUTTON_PIN_*.
+        // Returns:
+        //      The awaitable.
+        // 
+        DebouncerAwaiter Pressed(uint8_t GPIOButtonPins);
+        DebouncerAwaiter Released(uint8_t GPIOButtonPins);
+
+        // 
+        // Set Resume Hook
+        // Description:
+        //      Makes ButtonProcess hand coroutines that are ready to go on to
+        //      hook instead of resuming them directly.
+        // Parameters:
+        //      hook - The hook, or NULL to resume coroutines directly again.
+        //      context - Passed to the hook.
+        // Returns:
+        //      None
+        // 
+        void SetResumeHook(DebouncerResumeHook hook, void *context);
+
+        // 
+        // Button Pressed, Button Released and Button Current
+        // Description:
+        //      Same as the Debouncer functions of the same name.
+        // 
+        uint8_t ButtonPressed(uint8_t GPIOButtonPins);
+        uint8_t ButtonReleased(uint8_t GPIOButtonPins);
+        uint8_t ButtonCurrent(uint8_t GPIOButtonPins);
+
+    private:
+        friend class DebouncerAwaiter;
+
+        DebouncerAwaitPort(const DebouncerAwaitPort &) = delete;
+        DebouncerAwaitPort &operator=(const DebouncerAwaitPort &) = delete;
+
+        // 
+        // Puts an awaiter on the list of every pin it waits for
+        // 
+        void Link(DebouncerAwaiter *awaiter);
+
+        // 
+        // Takes an awaiter off every list it is on
+        // 
+        void Unlink(DebouncerAwaiter *awaiter);
+
+        Debouncer debouncer;
+
+        // 
+        // The awaiters waiting on each pin, by edge
+        // 
+        DebouncerAwaiter *waiters[2][8];
+
+        DebouncerResumeHook resumeHook;
+        void *resumeContext;
+};
+
+#endif  // BUTTON_DEBOUNCER_CORO_H
@@ -0,0 +1,278 @@
+//*********************************************************************************
+// State Button Debouncer - Quadrature Encoders
+// 
+// Revision: 1.0
+// 
+// Description: Debounces and decodes many quadrature rotary encoders at once.
+// See button_debounce_encoder.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <string.h>
+#include "button_debounce_encoder.h"
+
+//*********************************************************************************
+// Local Functions
+//*********************************************************************************
+
+// 
+// Gathers the even bits of a word into its low 32 bits: bit 2 * k moves to
+// bit k
+// 
+static uint64_t
+EvenBits(uint64_t x)
+{
+    x &= 0x5555555555555555ULL;
+    x = (x | (x >> 1)) & 0x3333333333333333ULL;
+    x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+    x = (x | (x >> 4)) & 0x00FF00FF00FF00FFULL;
+    x = (x | (x >> 8)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+
+    return x;
+}
+
+// 
+// Reads up to 8 ports into a word, port 0 in the lowest byte
+// 
+static uint64_t
+LoadPorts(const uint8_t *portStatus, uint32_t count)
+{
+    uint64_t x = 0;
+    uint32_t i;
+
+    for(i = 0; i < count; i++)
+    {
+        x |= (uint64_t)portStatus[i] << (8 * i);
+    }
+
+    return x;
+}
+
+//*********************************************************************************
+// Class Functions
+//*********************************************************************************
+QuadratureEncoderBank::
+QuadratureEncoderBank(uint32_t numEncoders, uint8_t depth, DebouncerArena *arena)
+{
+    this->numEncoders = numEncoders;
+    this->arena = arena;
+
+    // Keep the depth in its documented range. With no samples at all every
+    // pin would read as stable at 1.
+    if(depth < 1)
+    {
+        depth = 1;
+    }
+    else if(depth > NUM_BUTTON_STATES)
+    {
+        depth = NUM_BUTTON_STATES;
+    }
+    this->depth = depth;
+    numWords = (numEncoders + (BUTTON_ENCODER_WORD_BITS - 1)) / BUTTON_ENCODER_WORD_BITS;
+    index = 0;
+    started = false;
+    errors = 0;
+
+    historyA = DebouncerAllocate<uint64_t>(arena, (size_t)numWords * depth);
+    historyB = DebouncerAllocate<uint64_t>(arena, (size_t)numWords * depth);
+    stateA = DebouncerAllocate<uint64_t>(arena, numWords);
+    stateB = DebouncerAllocate<uint64_t>(arena, numWords);
+    moved = DebouncerAllocate<uint64_t>(arena, numWords);
+    scratchA = DebouncerAllocate<uint64_t>(arena, numWords);
+    scratchB = DebouncerAllocate<uint64_t>(arena, numWords);
+    counts = DebouncerAllocate<int32_t>(arena, numEncoders);
+
+    memset(moved, 0x00, sizeof(uint64_t) * numWords);
+    memset(counts, 0x00, sizeof(int32_t) * numEncoders);
+}
+
+QuadratureEncoderBank::
+~QuadratureEncoderBank()
+{
+    DebouncerFree(arena, historyA, (size_t)numWords * depth);
+    DebouncerFree(arena, historyB, (size_t)numWords * depth);
+    DebouncerFree(arena, stateA, numWords);
+    DebouncerFree(arena, stateB, numWords);
+    DebouncerFree(arena, moved, numWords);
+    DebouncerFree(arena, scratchA, numWords);
+    DebouncerFree(arena, scratchB, numWords);
+    DebouncerFree(arena, counts, numEncoders);
+}
+
+void QuadratureEncoderBank::
+EncoderProcess(const uint8_t *portStatus)
+{
+    const uint32_t numPorts = (numEncoders + (BUTTON_ENCODER_PER_PORT - 1)) /
+                              BUTTON_ENCODER_PER_PORT;
+    const uint32_t wordPorts = BUTTON_ENCODER_WORD_BITS / BUTTON_ENCODER_PER_PORT;
+    uint64_t low;
+    uint64_t high;
+    uint32_t port;
+    uint32_t count;
+    uint32_t word;
+
+    // Each word of encoders comes from 16 ports. The A pins are the even
+    // bits of the ports and the B pins the odd ones.
+    for(word = 0; word < numWords; word++)
+    {
+        port = word * wordPorts;
+
+        count = numPorts - port < wordPorts / 2 ? numPorts - port : wordPorts / 2;
+        low = LoadPorts(portStatus + port, count);
+
+        count = numPorts - port > wordPorts / 2 ? numPorts - port - wordPorts / 2 : 0;
+        high = LoadPorts(portStatus + port + wordPorts / 2,
+                         count < wordPorts / 2 ? count : wordPorts / 2);
+
+        scratchA[word] = EvenBits(low) | (EvenBits(high) << 32);
+        scratchB[word] = EvenBits(low >> 1) | (EvenBits(high >> 1) << 32);
+    }
+
+    EncoderProcessPins(scratchA, scratchB);
+}
+
+void QuadratureEncoderBank::
+EncoderProcessPins(const uint64_t *aPins, const uint64_t *bPins)
+{
+    uint64_t valid;
+    uint64_t allA;
+    uint64_t anyA;
+    uint64_t allB;
+    uint64_t anyB;
+    uint64_t newA;
+    uint64_t newB;
+    uint64_t step;
+    uint64_t forward;
+    uint32_t word;
+    uint32_t encoder;
+    uint8_t j;
+
+    for(word = 0; word < numWords; word++)
+    {
+        // Leave the encoders past the last one at 0
+        valid = numEncoders - word * BUTTON_ENCODER_WORD_BITS >= BUTTON_ENCODER_WORD_BITS ?
+                ~(uint64_t)0 :
+                ((uint64_t)1 << (numEncoders % BUTTON_ENCODER_WORD_BITS)) - 1;
+
+        historyA[(size_t)numWords * index + word] = aPins[word] & valid;
+        historyB[(size_t)numWords * index + word] = bPins[word] & valid;
+
+        // The first sample is where the encoders start from
+        if(!started)
+        {
+            for(j = 0; j < depth; j++)
+            {
+                historyA[(size_t)numWords * j + word] = aPins[word] & valid;
+                historyB[(size_t)numWords * j + word] = bPins[word] & valid;
+            }
+            stateA[word] = aPins[word] & valid;
+            stateB[word] = bPins[word] & valid;
+            moved[word] = 0;
+            continue;
+        }
+
+        // A pin goes to 1 once it read 1 in every sample and to 0 once it
+        // read 0 in every sample
+        allA = ~(uint64_t)0;
+        anyA = 0;
+        allB = ~(uint64_t)0;
+        anyB = 0;
+        for(j = 0; j < depth; j++)
+        {
+            allA &= historyA[(size_t)numWords * j + word];
+            anyA |= historyA[(size_t)numWords * j + word];
+            allB &= historyB[(size_t)numWords * j + word];
+            anyB |= historyB[(size_t)numWords * j + word];
+        }
+        newA = (stateA[word] & anyA) | allA;
+        newB = (stateB[word] & anyB) | allB;
+
+        // One pin changing is a step, both changing is a missed step
+        step = (newA ^ stateA[word]) ^ (newB ^ stateB[word]);
+        errors += __builtin_popcountll((newA ^ stateA[word]) & (newB ^ stateB[word]));
+        forward = step & (newA ^ stateB[word]);
+
+        stateA[word] = newA;
+        stateB[word] = newB;
+        moved[word] = step;
+
+        // Few encoders move on any one sample, so only visit those
+        while(step != 0)
+        {
+            encoder = word * BUTTON_ENCODER_WORD_BITS + __builtin_ctzll(step);
+            counts[encoder] += (forward & step & (~step + 1)) != 0 ? 1 : -1;
+            step &= step - 1;
+        }
+    }
+
+    started = true;
+
+    // Check to make sure the index hasn't gone over the limit
+    index++;
+    if(index >= depth)
+    {
+        index = 0;
+    }
+}
+
+int32_t QuadratureEncoderBank::
+Count(uint32_t encoder) const
+{
+    return counts[encoder];
+}
+
+int32_t QuadratureEncoderBank::
+TakeCount(uint32_t encoder)
+{
+    int32_t count = counts[encoder];
+
+    counts[encoder] = 0;
+
+    return count;
+}
+
+const uint64_t *QuadratureEncoderBank::
+Moved() const
+{
+    return moved;
+}
+
+uint64_t QuadratureEncoderBank::
+Errors() const
+{
+    return errors;
+}
+
+uint32_t QuadratureEncoderBank::
+NumEncoders() const
+{
+    return numEncoders;
+}
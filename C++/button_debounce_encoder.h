@@ -0,0 +1,205 @@
+//*********************************************************************************
+// State Button Debouncer - Quadrature Encoders
+// 
+// Revision: 1.0
+// 
+// Description: Debounces and decodes many quadrature rotary encoders at once.
+// The encoders are held bit sliced: one 64 bit word carries the A pin of 64
+// encoders and another their B pin, so debouncing, finding steps and telling
+// their direction are a handful of bitwise operations per 64 encoders.
+// 
+// Encoder contacts bounce in both directions, so unlike the button
+// debouncers a pin only changes once it has read the same in depth samples
+// in a row. A step is a change of exactly one of A and B. It goes forward
+// when the new A differs from the old B and backward otherwise, which gives
+// the same direction whether the contacts pull the pins up or down. A change
+// of both pins at once means a step was missed and is counted as an error.
+// Each encoder keeps a signed count of quarter steps.
+// 
+// Encoders are read from ports of 8 pins, four encoders per port: encoder i
+// is on port i / 4 with A on pin 2 * (i % 4) and B on the pin above it.
+// Callers holding A and B masks already can hand them over directly.
+// 
+// Requires C++11.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_ENCODER_H
+#define BUTTON_DEBOUNCER_ENCODER_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include "button_debounce.h"
+#include "button_debounce_arena.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// The number of encoders held in one word of A or B pins
+#define BUTTON_ENCODER_WORD_BITS    64
+
+// The number of encoders on one port
+#define BUTTON_ENCODER_PER_PORT     4
+
+//*********************************************************************************
+// Class
+//*********************************************************************************
+
+class
+QuadratureEncoderBank
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Initializes the encoders with counts of 0. The first sample
+        //      processed is taken as the encoders' starting position.
+        // Parameters:
+        //      numEncoders - The number of encoders.
+        //      depth - The number of samples in a row a pin must read the
+        //          same in before it changes, from 1 to NUM_BUTTON_STATES. 1
+        //          decodes the raw pins, for inputs that are debounced
+        //          already. Depths outside of that range are clamped to it.
+        //      arena - Where to allocate the bank from, or NULL for the
+        //          heap.
+        // Returns:
+        //      None
+        // 
+        QuadratureEncoderBank(uint32_t numEncoders, uint8_t depth,
+                              DebouncerArena *arena = NULL);
+        ~QuadratureEncoderBank();
+
+        // 
+        // Encoder Process
+        // Description:
+        //      Samples every encoder from its port and decodes the steps.
+        //      Should be called on a regular interval, at least four times
+        //      per detent at the fastest expected turning speed times depth.
+        // Parameters:
+        //      portStatus - One status byte per port, (numEncoders + 3) / 4
+        //          ports.
+        // Returns:
+        //      None
+        // 
+        void EncoderProcess(const uint8_t *portStatus);
+
+        // 
+        // Encoder Process Pins
+        // Description:
+        //      Same as above with the pins already split into masks.
+        // Parameters:
+        //      aPins - The A pins, one bit per encoder, encoder 0 in bit 0
+        //          of aPins[0]. (numEncoders + 63) / 64 words.
+        //      bPins - The B pins, laid out the same way.
+        // Returns:
+        //      None
+        // 
+        void EncoderProcessPins(const uint64_t *aPins, const uint64_t *bPins);
+
+        // 
+        // Count
+        // Description:
+        //      Gets the number of quarter steps an encoder has turned since
+        //      it was last reset, positive for forward.
+        // 
+        int32_t Count(uint32_t encoder) const;
+
+        // 
+        // Take Count
+        // Description:
+        //      Gets an encoder's count and sets it back to 0.
+        // 
+        int32_t TakeCount(uint32_t encoder);
+
+        // 
+        // Moved
+        // Description:
+        //      Gives the encoders that stepped in the last sample, one bit per
+        //      encoder in the same layout as the aPins of EncoderProcessPins.
+        // 
+        const uint64_t *Moved() const;
+
+        // 
+        // Errors
+        // Description:
+        //      Gets the number of missed steps seen on all encoders.
+        // 
+        uint64_t Errors() const;
+
+        // 
+        // Num Encoders
+        // Description:
+        //      Gets the number of encoders.
+        // 
+        uint32_t NumEncoders() const;
+
+    private:
+        QuadratureEncoderBank(const QuadratureEncoderBank &);
+        QuadratureEncoderBank &operator=(const QuadratureEncoderBank &);
+
+        uint32_t numEncoders;
+        uint32_t numWords;
+        uint8_t depth;
+        DebouncerArena *arena;
+
+        // 
+        // Keeps up with which history row gets the next sample, and whether
+        // there has been a sample yet
+        // 
+        uint8_t index;
+        bool started;
+
+        // 
+        // depth rows of numWords samples of the A and B pins
+        // 
+        uint64_t *historyA;
+        uint64_t *historyB;
+
+        // 
+        // The debounced A and B pins and the encoders that just stepped
+        // 
+        uint64_t *stateA;
+        uint64_t *stateB;
+        uint64_t *moved;
+
+        // 
+        // The pins split out of the ports by EncoderProcess
+        // 
+        uint64_t *scratchA;
+        uint64_t *scratchB;
+
+        int32_t *counts;
+        uint64_t errors;
+};
+
+#endif  // BUTTON_DEBOUNCER_ENCODER_H
@@ -0,0 +1,143 @@
+//*********************************************************************************
+// State Button Debouncer - Shift Register Frames
+// 
+// Revision: 1.0
+// 
+// Description: Debounces the frames read from a chain of shift registers.
+// See button_debounce_frame.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include "button_debounce_frame.h"
+
+//*********************************************************************************
+// Class Functions
+//*********************************************************************************
+FrameDebouncer::
+FrameDebouncer(uint32_t frameBytes, uint8_t pulledUpButtons, uint32_t options,
+               DebouncerArena *arena) :
+    arena(arena),
+    bank(frameBytes, pulledUpButtons, arena, BUTTON_BANK_SHARED_PULL)
+{
+    reversed = NULL;
+    if(options & BUTTON_FRAME_REVERSED)
+    {
+        reversed = DebouncerAllocate<uint8_t>(arena, frameBytes);
+    }
+}
+
+FrameDebouncer::
+~FrameDebouncer()
+{
+    if(reversed != NULL)
+    {
+        DebouncerFree(arena, reversed, bank.NumPorts());
+    }
+}
+
+void FrameDebouncer::
+ButtonProcess(const uint8_t *frame)
+{
+    ButtonProcessPart(0, frame, bank.NumPorts());
+    EndFrame();
+}
+
+void FrameDebouncer::
+ButtonProcessPart(uint32_t offset, const uint8_t *bytes, uint32_t count)
+{
+    uint32_t firstPort;
+    uint32_t i;
+
+    if(reversed == NULL)
+    {
+        bank.ButtonProcessRange(offset, count, bytes);
+        return;
+    }
+
+    // The piece covers the ports just below the mirror image of offset
+    firstPort = bank.NumPorts() - offset - count;
+    for(i = 0; i < count; i++)
+    {
+        reversed[firstPort + i] = bytes[count - 1 - i];
+    }
+
+    bank.ButtonProcessRange(firstPort, count, reversed + firstPort);
+}
+
+void FrameDebouncer::
+EndFrame()
+{
+    bank.AdvanceIndex();
+}
+
+uint32_t FrameDebouncer::
+ChangedPorts(uint32_t firstPort, uint32_t *ports, uint32_t maxPorts) const
+{
+    DebouncerBank::ChangedIterator it(bank, firstPort);
+    uint32_t numFound = 0;
+    uint32_t port;
+
+    while(numFound < maxPorts && it.Next(port))
+    {
+        ports[numFound++] = port;
+    }
+
+    return numFound;
+}
+
+uint8_t FrameDebouncer::
+ButtonPressed(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    return bank.ButtonPressed(port, GPIOButtonPins);
+}
+
+uint8_t FrameDebouncer::
+ButtonReleased(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    return bank.ButtonReleased(port, GPIOButtonPins);
+}
+
+uint8_t FrameDebouncer::
+ButtonCurrent(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    return bank.ButtonCurrent(port, GPIOButtonPins);
+}
+
+uint32_t FrameDebouncer::
+NumPorts() const
+{
+    return bank.NumPorts();
+}
+
+const DebouncerBank &FrameDebouncer::
+Bank() const
+{
+    return bank;
+}
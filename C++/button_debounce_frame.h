@@ -0,0 +1,176 @@
+//*********************************************************************************
+// State Button Debouncer - Shift Register Frames
+// 
+// Revision: 1.0
+// 
+// Description: Debounces the frames read from a chain of parallel in, serial
+// out shift registers such as the 74HC165. Every byte of a frame is one
+// register and becomes one port of a DebouncerBank, so a whole frame is
+// debounced in one call working on many bytes at a time instead of one
+// Debouncer call per byte.
+// 
+// A frame can be handed over whole or in pieces as they arrive, for example
+// from a DMA transfer, followed by EndFrame. The ports that changed are
+// collected in batches through the bank's summary bitmaps, so a frame without
+// changes costs almost nothing to check.
+// 
+// The first byte shifted out of a chain comes from the register nearest to
+// the microcontroller. BUTTON_FRAME_REVERSED numbers the ports from the
+// other end of the chain instead.
+// 
+// Requires C++11.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_FRAME_H
+#define BUTTON_DEBOUNCER_FRAME_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include "button_debounce_arena.h"
+#include "button_debounce_bank.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// Port i is byte i of the frame
+#define BUTTON_FRAME_DEFAULT        0x00
+
+// Port i is byte frameBytes - 1 - i of the frame
+#define BUTTON_FRAME_REVERSED       0x01
+
+//*********************************************************************************
+// Class
+//*********************************************************************************
+
+class
+FrameDebouncer
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Initializes a debouncer for frames of frameBytes bytes.
+        // Parameters:
+        //      frameBytes - The number of bytes in a frame.
+        //      pulledUpButtons - The pullups used on every register. See the
+        //          Debouncer constructor.
+        //      options - BUTTON_FRAME_DEFAULT or BUTTON_FRAME_REVERSED.
+        //      arena - Where to allocate the debouncer from, or NULL for the
+        //          heap.
+        // Returns:
+        //      None
+        // 
+        FrameDebouncer(uint32_t frameBytes, uint8_t pulledUpButtons, uint32_t options,
+                       DebouncerArena *arena = NULL);
+        ~FrameDebouncer();
+
+        // 
+        // Button Process
+        // Description:
+        //      Debounces a whole frame.
+        // Parameters:
+        //      frame - The frame, frameBytes bytes.
+        // Returns:
+        //      None
+        // 
+        void ButtonProcess(const uint8_t *frame);
+
+        // 
+        // Button Process Part and End Frame
+        // Description:
+        //      Debounce a frame that arrives in pieces. Every byte of the
+        //      frame must be handed to ButtonProcessPart once, in any order,
+        //      before calling EndFrame.
+        // Parameters:
+        //      offset - The position of the piece's first byte in the frame.
+        //      bytes - The piece.
+        //      count - The number of bytes in the piece.
+        // Returns:
+        //      None
+        // 
+        void ButtonProcessPart(uint32_t offset, const uint8_t *bytes, uint32_t count);
+        void EndFrame();
+
+        // 
+        // Changed Ports
+        // Description:
+        //      Collects the ports that changed in the last frame, in
+        //      increasing order.
+        // Parameters:
+        //      firstPort - The first port that may be collected. 0 to start,
+        //          or one past the last port of the previous batch to carry
+        //          on.
+        //      ports - Filled in with the ports.
+        //      maxPorts - The room in ports.
+        // Returns:
+        //      The number of ports collected. Fewer than maxPorts means
+        //      every changed port has been collected.
+        // 
+        uint32_t ChangedPorts(uint32_t firstPort, uint32_t *ports, uint32_t maxPorts) const;
+
+        // 
+        // Button Pressed, Button Released and Button Current
+        // Description:
+        //      Same as the Debouncer functions of the same name for one port.
+        // Parameters:
+        //      port - The port.
+        //      GPIOButtonPins - The ORed combination of BUTTON_PIN_*.
+        // 
+        uint8_t ButtonPressed(uint32_t port, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonReleased(uint32_t port, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonCurrent(uint32_t port, uint8_t GPIOButtonPins) const;
+
+        // 
+        // Num Ports and Bank
+        // Description:
+        //      Get the number of ports, which is the number of bytes in a
+        //      frame, and the bank holding them.
+        // 
+        uint32_t NumPorts() const;
+        const DebouncerBank &Bank() const;
+
+    private:
+        FrameDebouncer(const FrameDebouncer &);
+        FrameDebouncer &operator=(const FrameDebouncer &);
+
+        DebouncerArena *arena;
+        DebouncerBank bank;
+
+        // 
+        // The frame in port order when it is reversed, otherwise NULL
+        // 
+        uint8_t *reversed;
+};
+
+#endif  // BUTTON_DEBOUNCER_FRAME_H
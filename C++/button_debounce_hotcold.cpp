@@ -0,0 +1,262 @@
+//*********************************************************************************
+// State Button Debouncer - Hot/Cold Bank
+// 
+// Revision: 1.0
+// 
+// Description: A bank with the state read by queries kept apart from the
+// sample history and with ports ordered by activity. See
+// button_debounce_hotcold.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <string.h>
+#include <algorithm>
+#include "button_debounce_hotcold.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// The number of slots debounced together by ButtonProcess
+#define BUTTON_HOTCOLD_BLOCK_PORTS  64
+
+//*********************************************************************************
+// Class Functions
+//*********************************************************************************
+HotColdDebouncerBank::
+HotColdDebouncerBank(uint32_t numPorts, uint8_t pulledUpButtons, DebouncerArena *arena)
+{
+    uint32_t i;
+
+    this->numPorts = numPorts;
+    this->arena = arena;
+    index = 0;
+
+    hot = DebouncerAllocate<DebouncerHotState>(arena, numPorts);
+    state = DebouncerAllocate<uint8_t>(arena, (size_t)numPorts * NUM_BUTTON_STATES);
+    pullType = DebouncerAllocate<uint8_t>(arena, numPorts);
+    activity = DebouncerAllocate<uint32_t>(arena, numPorts);
+    handleToSlot = DebouncerAllocate<uint32_t>(arena, numPorts);
+    slotToHandle = DebouncerAllocate<uint32_t>(arena, numPorts);
+    order = DebouncerAllocate<uint32_t>(arena, numPorts);
+    scratch = DebouncerAllocate<uint8_t>(arena, (size_t)numPorts * sizeof(uint32_t));
+
+    memset(hot, 0x00, sizeof(DebouncerHotState) * numPorts);
+    memset(state, 0x00, (size_t)numPorts * NUM_BUTTON_STATES);
+    memset(pullType, pulledUpButtons, numPorts);
+    memset(activity, 0x00, sizeof(uint32_t) * numPorts);
+
+    for(i = 0; i < numPorts; i++)
+    {
+        handleToSlot[i] = i;
+        slotToHandle[i] = i;
+    }
+}
+
+HotColdDebouncerBank::
+~HotColdDebouncerBank()
+{
+    DebouncerFree(arena, hot, numPorts);
+    DebouncerFree(arena, state, (size_t)numPorts * NUM_BUTTON_STATES);
+    DebouncerFree(arena, pullType, numPorts);
+    DebouncerFree(arena, activity, numPorts);
+    DebouncerFree(arena, handleToSlot, numPorts);
+    DebouncerFree(arena, slotToHandle, numPorts);
+    DebouncerFree(arena, order, numPorts);
+    DebouncerFree(arena, scratch, (size_t)numPorts * sizeof(uint32_t));
+}
+
+void HotColdDebouncerBank::
+SetPullType(uint32_t handle, uint8_t pulledUpButtons)
+{
+    pullType[handleToSlot[handle]] = pulledUpButtons;
+}
+
+void HotColdDebouncerBank::
+ButtonProcess(const uint8_t *portStatus)
+{
+    uint8_t debounced[BUTTON_HOTCOLD_BLOCK_PORTS];
+    uint8_t *newest = state + (size_t)numPorts * index;
+    const uint8_t *row;
+    uint8_t changed;
+    uint32_t slot;
+    uint32_t count;
+    uint32_t i;
+    uint8_t j;
+
+    for(slot = 0; slot < numPorts; slot += count)
+    {
+        count = numPorts - slot;
+        if(count > BUTTON_HOTCOLD_BLOCK_PORTS)
+        {
+            count = BUTTON_HOTCOLD_BLOCK_PORTS;
+        }
+
+        // Gather the statuses of the handles in these slots
+        for(i = 0; i < count; i++)
+        {
+            newest[slot + i] = portStatus[slotToHandle[slot + i]] ^ pullType[slot + i];
+        }
+
+        for(i = 0; i < count; i++)
+        {
+            debounced[i] = 0xFF;
+        }
+        for(j = 0; j < NUM_BUTTON_STATES; j++)
+        {
+            row = state + (size_t)numPorts * j + slot;
+            for(i = 0; i < count; i++)
+            {
+                debounced[i] &= row[i];
+            }
+        }
+
+        for(i = 0; i < count; i++)
+        {
+            changed = debounced[i] ^ hot[slot + i].debouncedState;
+            hot[slot + i].changed = changed;
+            hot[slot + i].debouncedState = debounced[i];
+            activity[slot + i] += (changed != 0);
+        }
+    }
+
+    // Check to make sure the index hasn't gone over the limit
+    index++;
+    if(index >= NUM_BUTTON_STATES)
+    {
+        index = 0;
+    }
+}
+
+void HotColdDebouncerBank::
+Reorder()
+{
+    DebouncerHotState *hotScratch = (DebouncerHotState *)scratch;
+    uint32_t *wordScratch = (uint32_t *)scratch;
+    uint8_t *row;
+    uint32_t slot;
+    uint8_t j;
+
+    // order[new slot] = old slot, most active first. Ties are broken by
+    // slot so the sort is stable without std::stable_sort, which may
+    // allocate.
+    for(slot = 0; slot < numPorts; slot++)
+    {
+        order[slot] = slot;
+    }
+    std::sort(order, order + numPorts, [this](uint32_t a, uint32_t b)
+    {
+        return activity[a] > activity[b] || (activity[a] == activity[b] && a < b);
+    });
+
+    // Move every per slot array into the new order through the scratch
+    // space, which is large enough for the widest of them
+    for(slot = 0; slot < numPorts; slot++)
+    {
+        hotScratch[slot] = hot[order[slot]];
+    }
+    memcpy(hot, hotScratch, sizeof(DebouncerHotState) * numPorts);
+
+    for(j = 0; j < NUM_BUTTON_STATES; j++)
+    {
+        row = state + (size_t)numPorts * j;
+        for(slot = 0; slot < numPorts; slot++)
+        {
+            scratch[slot] = row[order[slot]];
+        }
+        memcpy(row, scratch, numPorts);
+    }
+
+    for(slot = 0; slot < numPorts; slot++)
+    {
+        scratch[slot] = pullType[order[slot]];
+    }
+    memcpy(pullType, scratch, numPorts);
+
+    for(slot = 0; slot < numPorts; slot++)
+    {
+        wordScratch[slot] = slotToHandle[order[slot]];
+    }
+    memcpy(slotToHandle, wordScratch, sizeof(uint32_t) * numPorts);
+
+    for(slot = 0; slot < numPorts; slot++)
+    {
+        handleToSlot[slotToHandle[slot]] = slot;
+    }
+
+    // Start counting afresh so that the next order follows recent activity
+    memset(activity, 0x00, sizeof(uint32_t) * numPorts);
+}
+
+uint8_t HotColdDebouncerBank::
+ButtonPressed(uint32_t handle, uint8_t GPIOButtonPins) const
+{
+    const DebouncerHotState *h = &hot[handleToSlot[handle]];
+
+    return (h->changed & h->debouncedState) & GPIOButtonPins;
+}
+
+uint8_t HotColdDebouncerBank::
+ButtonReleased(uint32_t handle, uint8_t GPIOButtonPins) const
+{
+    const DebouncerHotState *h = &hot[handleToSlot[handle]];
+
+    return (h->changed & (~h->debouncedState)) & GPIOButtonPins;
+}
+
+uint8_t HotColdDebouncerBank::
+ButtonCurrent(uint32_t handle, uint8_t GPIOButtonPins) const
+{
+    return hot[handleToSlot[handle]].debouncedState & GPIOButtonPins;
+}
+
+uint32_t HotColdDebouncerBank::
+SlotOf(uint32_t handle) const
+{
+    return handleToSlot[handle];
+}
+
+uint32_t HotColdDebouncerBank::
+HandleOf(uint32_t slot) const
+{
+    return slotToHandle[slot];
+}
+
+const DebouncerHotState *HotColdDebouncerBank::
+HotStates() const
+{
+    return hot;
+}
+
+uint32_t HotColdDebouncerBank::
+NumPorts() const
+{
+    return numPorts;
+}
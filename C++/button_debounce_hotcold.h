@@ -0,0 +1,208 @@
+//*********************************************************************************
+// State Button Debouncer - Hot/Cold Bank
+// 
+// Revision: 1.0
+// 
+// Description: A bank laid out for programs that query ports far more often
+// than they are processed. The debounced state and changed pins that every
+// query reads are kept together in one small array (the hot array), away from
+// the sample history and pull types that only ButtonProcess touches (the cold
+// arrays). A query then touches two bytes next to each other instead of
+// pulling history into the cache.
+// 
+// Ports are named by a handle that never changes, while the slot that holds
+// a port's state can move. Reorder packs the ports that changed most often
+// since the last reorder into the first slots, so the hot state of the active
+// ports shares as few cache lines as possible. Calling Reorder every few
+// seconds keeps the order in step with the activity of the ports.
+// 
+// Requires C++11.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_HOTCOLD_H
+#define BUTTON_DEBOUNCER_HOTCOLD_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include "button_debounce.h"
+#include "button_debounce_arena.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// 
+// The state of one slot read by queries
+// 
+struct
+DebouncerHotState
+{
+    uint8_t debouncedState;
+    uint8_t changed;
+};
+
+//*********************************************************************************
+// Class
+//*********************************************************************************
+
+class
+HotColdDebouncerBank
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Initializes a bank of released ports. Port handle i starts
+        //      out in slot i.
+        // Parameters:
+        //      numPorts - The number of ports in the bank.
+        //      pulledUpButtons - The pullups used on every port. See the
+        //          Debouncer constructor.
+        //      arena - Where to allocate the bank from, or NULL for the
+        //          heap.
+        // Returns:
+        //      None
+        // 
+        HotColdDebouncerBank(uint32_t numPorts, uint8_t pulledUpButtons,
+                             DebouncerArena *arena = NULL);
+        ~HotColdDebouncerBank();
+
+        // 
+        // Set Pull Type
+        // Description:
+        //      Changes the pullups used on one port.
+        // 
+        void SetPullType(uint32_t handle, uint8_t pulledUpButtons);
+
+        // 
+        // Button Process
+        // Description:
+        //      Debounces every port of the bank.
+        // Parameters:
+        //      portStatus - One status byte per port, indexed by handle.
+        // Returns:
+        //      None
+        // 
+        void ButtonProcess(const uint8_t *portStatus);
+
+        // 
+        // Reorder
+        // Description:
+        //      Moves the ports that changed most often since the last call
+        //      into the first slots, keeping ports that were equally active
+        //      in their current order. Must not be called in the middle of
+        //      a tick.
+        // Parameters:
+        //      None
+        // Returns:
+        //      None
+        // 
+        void Reorder();
+
+        // 
+        // Button Pressed, Button Released and Button Current
+        // Description:
+        //      Same as the Debouncer functions of the same name for one port.
+        // Parameters:
+        //      handle - The port's handle.
+        //      GPIOButtonPins - The ORed combination of BUTTON_PIN_*.
+        // 
+        uint8_t ButtonPressed(uint32_t handle, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonReleased(uint32_t handle, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonCurrent(uint32_t handle, uint8_t GPIOButtonPins) const;
+
+        // 
+        // Slot Of and Handle Of
+        // Description:
+        //      Translate between a port's handle and the slot that currently
+        //      holds it.
+        // 
+        uint32_t SlotOf(uint32_t handle) const;
+        uint32_t HandleOf(uint32_t slot) const;
+
+        // 
+        // Hot States
+        // Description:
+        //      Gives direct read access to the hot array, indexed by slot.
+        //      Scanning the first slots after a Reorder visits the most
+        //      active ports first.
+        // 
+        const DebouncerHotState *HotStates() const;
+
+        // 
+        // Num Ports
+        // Description:
+        //      Gets the number of ports in the bank.
+        // 
+        uint32_t NumPorts() const;
+
+    private:
+        HotColdDebouncerBank(const HotColdDebouncerBank &);
+        HotColdDebouncerBank &operator=(const HotColdDebouncerBank &);
+
+        uint32_t numPorts;
+        DebouncerArena *arena;
+
+        // 
+        // Keeps up with which state array gets the next port statuses
+        // 
+        uint8_t index;
+
+        // 
+        // The hot array, indexed by slot
+        // 
+        DebouncerHotState *hot;
+
+        // 
+        // The cold arrays, indexed by slot. NUM_BUTTON_STATES arrays of
+        // numPorts samples, the pull types and the number of ticks each
+        // slot changed on since the last Reorder.
+        // 
+        uint8_t *state;
+        uint8_t *pullType;
+        uint32_t *activity;
+
+        // 
+        // The slot each handle is in and the handle each slot holds
+        // 
+        uint32_t *handleToSlot;
+        uint32_t *slotToHandle;
+
+        // 
+        // Scratch space for Reorder
+        // 
+        uint32_t *order;
+        uint8_t *scratch;
+};
+
+#endif  // BUTTON_DEBOUNCER_HOTCOLD_H
@@ -0,0 +1,295 @@
+//*********************************************************************************
+// State Button Debouncer - Device ID Index
+// 
+// Revision: 1.0
+// 
+// Description: Finds the debouncer slot of a device from its 32 bit hardware
+// ID. See button_debounce_index.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include "button_debounce_index.h"
+
+//*********************************************************************************
+// Class Functions
+//*********************************************************************************
+DebouncerIdIndex::
+DebouncerIdIndex(uint32_t maxIds, DebouncerArena *arena)
+{
+    uint32_t capacity = 2;
+    uint32_t bits = 1;
+    uint32_t i;
+
+    // Keep the table at most half full
+    while(capacity < 2 * (uint64_t)maxIds)
+    {
+        capacity <<= 1;
+        bits++;
+    }
+
+    this->arena = arena;
+    table = DebouncerAllocate<Entry>(arena, capacity);
+    mask = capacity - 1;
+    shift = 32 - bits;
+    size = 0;
+    this->maxIds = maxIds;
+
+    for(i = 0; i < capacity; i++)
+    {
+        table[i].id = 0;
+        table[i].slot = BUTTON_INDEX_NOT_FOUND;
+    }
+}
+
+DebouncerIdIndex::
+~DebouncerIdIndex()
+{
+    DebouncerFree(arena, table, (size_t)mask + 1);
+}
+
+uint32_t DebouncerIdIndex::
+Home(uint32_t id) const
+{
+    // Fibonacci hashing spreads IDs that only differ in their low bits,
+    // such as consecutive ones, all over the table
+    return (uint32_t)(id * 0x9E3779B1u) >> shift;
+}
+
+uint32_t DebouncerIdIndex::
+Distance(uint32_t position) const
+{
+    return (position - Home(table[position].id)) & mask;
+}
+
+bool DebouncerIdIndex::
+Insert(uint32_t id, uint32_t slot)
+{
+    Entry entry;
+    Entry swap;
+    uint32_t position = Home(id);
+    uint32_t distance = 0;
+
+    entry.id = id;
+    entry.slot = slot;
+
+    while(1)
+    {
+        if(table[position].slot == BUTTON_INDEX_NOT_FOUND)
+        {
+            if(size == maxIds)
+            {
+                return false;
+            }
+            table[position] = entry;
+            size++;
+            return true;
+        }
+
+        if(table[position].id == entry.id)
+        {
+            table[position].slot = entry.slot;
+            return true;
+        }
+
+        // Take the position from an entry that is closer to its home than
+        // this one and carry on inserting that entry instead. Once an ID
+        // has been displaced it can't already be further along.
+        if(Distance(position) < distance)
+        {
+            if(size == maxIds)
+            {
+                return false;
+            }
+            swap = table[position];
+            table[position] = entry;
+            entry = swap;
+            distance = Distance(position);
+
+            while(1)
+            {
+                position = (position + 1) & mask;
+                distance++;
+
+                if(table[position].slot == BUTTON_INDEX_NOT_FOUND)
+                {
+                    table[position] = entry;
+                    size++;
+                    return true;
+                }
+
+                if(Distance(position) < distance)
+                {
+                    swap = table[position];
+                    table[position] = entry;
+                    entry = swap;
+                    distance = Distance(position);
+                }
+            }
+        }
+
+        position = (position + 1) & mask;
+        distance++;
+    }
+}
+
+bool DebouncerIdIndex::
+Erase(uint32_t id)
+{
+    uint32_t position = Home(id);
+    uint32_t distance = 0;
+    uint32_t next;
+
+    while(1)
+    {
+        if(table[position].slot == BUTTON_INDEX_NOT_FOUND || Distance(position) < distance)
+        {
+            return false;
+        }
+
+        if(table[position].id == id)
+        {
+            break;
+        }
+
+        position = (position + 1) & mask;
+        distance++;
+    }
+
+    // Shift the entries after it back by one until one is at home or the
+    // table has a hole, so that no lookup has to look past a hole
+    next = (position + 1) & mask;
+    while(table[next].slot != BUTTON_INDEX_NOT_FOUND && Distance(next) != 0)
+    {
+        table[position] = table[next];
+        position = next;
+        next = (next + 1) & mask;
+    }
+    table[position].slot = BUTTON_INDEX_NOT_FOUND;
+    size--;
+
+    return true;
+}
+
+uint32_t DebouncerIdIndex::
+Find(uint32_t id) const
+{
+    uint32_t position = Home(id);
+    uint32_t distance = 0;
+
+    // An ID can't be further along than an entry that is closer to its own
+    // home, which ends unsuccessful lookups early
+    while(table[position].slot != BUTTON_INDEX_NOT_FOUND && Distance(position) >= distance)
+    {
+        if(table[position].id == id)
+        {
+            return table[position].slot;
+        }
+
+        position = (position + 1) & mask;
+        distance++;
+    }
+
+    return BUTTON_INDEX_NOT_FOUND;
+}
+
+void DebouncerIdIndex::
+FindBatch(const uint32_t *ids, uint32_t count, uint32_t *slots) const
+{
+    uint32_t i;
+
+    for(i = 0; i < count; i++)
+    {
+        if(i + BUTTON_INDEX_PREFETCH < count)
+        {
+            __builtin_prefetch(&table[Home(ids[i + BUTTON_INDEX_PREFETCH])]);
+        }
+        slots[i] = Find(ids[i]);
+    }
+}
+
+uint32_t DebouncerIdIndex::
+IngestTagged(const uint32_t *ids, const uint8_t *samples, uint32_t count,
+             Debouncer *ports) const
+{
+    uint32_t unknown = 0;
+    uint32_t slot;
+    uint32_t i;
+
+    for(i = 0; i < count; i++)
+    {
+        if(i + BUTTON_INDEX_PREFETCH < count)
+        {
+            __builtin_prefetch(&table[Home(ids[i + BUTTON_INDEX_PREFETCH])]);
+        }
+
+        slot = Find(ids[i]);
+        if(slot == BUTTON_INDEX_NOT_FOUND)
+        {
+            unknown++;
+            continue;
+        }
+        ports[slot].ButtonProcess(samples[i]);
+    }
+
+    return unknown;
+}
+
+uint32_t DebouncerIdIndex::
+IngestTagged(const uint32_t *ids, const uint8_t *samples, uint32_t count,
+             uint8_t *portStatus) const
+{
+    uint32_t unknown = 0;
+    uint32_t slot;
+    uint32_t i;
+
+    for(i = 0; i < count; i++)
+    {
+        if(i + BUTTON_INDEX_PREFETCH < count)
+        {
+            __builtin_prefetch(&table[Home(ids[i + BUTTON_INDEX_PREFETCH])]);
+        }
+
+        slot = Find(ids[i]);
+        if(slot == BUTTON_INDEX_NOT_FOUND)
+        {
+            unknown++;
+            continue;
+        }
+        portStatus[slot] = samples[i];
+    }
+
+    return unknown;
+}
+
+uint32_t DebouncerIdIndex::
+Size() const
+{
+    return size;
+}
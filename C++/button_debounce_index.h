@@ -0,0 +1,213 @@
+//*********************************************************************************
+// State Button Debouncer - Device ID Index
+// 
+// Revision: 1.0
+// 
+// Description: Finds the debouncer slot of a device from its 32 bit hardware
+// ID. The IDs are kept in one flat open addressing table using Robin Hood
+// hashing: an ID that has been pushed further from its home position than
+// the ID sitting in the way takes that position, so every ID stays close to
+// where its hash says it should be. A lookup usually reads a single cache
+// line and never follows a pointer.
+// 
+// Samples that arrive tagged with their device's ID can be looked up and
+// debounced in one go with IngestTagged. Lookups of a batch of IDs prefetch
+// the table positions of IDs further down the batch so that several cache
+// misses are in flight at once.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_INDEX_H
+#define BUTTON_DEBOUNCER_INDEX_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include "button_debounce.h"
+#include "button_debounce_arena.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// Returned by lookups of IDs that aren't in the index
+#define BUTTON_INDEX_NOT_FOUND      0xFFFFFFFF
+
+// How many IDs ahead batched lookups prefetch
+#define BUTTON_INDEX_PREFETCH       8
+
+//*********************************************************************************
+// Class
+//*********************************************************************************
+
+class
+DebouncerIdIndex
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Initializes an empty index. The table is sized so that it is
+        //      never more than half full.
+        // Parameters:
+        //      maxIds - The most IDs the index can hold.
+        //      arena - Where to allocate the table from, or NULL for the
+        //          heap.
+        // Returns:
+        //      None
+        // 
+        DebouncerIdIndex(uint32_t maxIds, DebouncerArena *arena = NULL);
+        ~DebouncerIdIndex();
+
+        // 
+        // Insert
+        // Description:
+        //      Maps an ID to a slot, replacing the slot it was mapped to if it
+        //      was already in the index.
+        // Parameters:
+        //      id - The device ID.
+        //      slot - The device's slot. Must not be BUTTON_INDEX_NOT_FOUND.
+        // Returns:
+        //      False if the index already holds maxIds IDs.
+        // 
+        bool Insert(uint32_t id, uint32_t slot);
+
+        // 
+        // Erase
+        // Description:
+        //      Removes an ID from the index.
+        // Parameters:
+        //      id - The device ID.
+        // Returns:
+        //      False if the ID wasn't in the index.
+        // 
+        bool Erase(uint32_t id);
+
+        // 
+        // Find
+        // Description:
+        //      Looks up the slot of one ID.
+        // Parameters:
+        //      id - The device ID.
+        // Returns:
+        //      The slot, or BUTTON_INDEX_NOT_FOUND.
+        // 
+        uint32_t Find(uint32_t id) const;
+
+        // 
+        // Find Batch
+        // Description:
+        //      Looks up the slots of several IDs.
+        // Parameters:
+        //      ids - The device IDs.
+        //      count - The number of IDs.
+        //      slots - Filled in with the slot of each ID, or
+        //          BUTTON_INDEX_NOT_FOUND.
+        // Returns:
+        //      None
+        // 
+        void FindBatch(const uint32_t *ids, uint32_t count, uint32_t *slots) const;
+
+        // 
+        // Ingest Tagged
+        // Description:
+        //      Looks up the slot of each sample's ID and debounces the sample
+        //      with the Debouncer in that slot.
+        // Parameters:
+        //      ids - The ID of the device each sample came from.
+        //      samples - The port statuses.
+        //      count - The number of samples.
+        //      ports - The Debouncers, indexed by slot.
+        // Returns:
+        //      The number of samples whose ID wasn't in the index. Those
+        //      samples are dropped.
+        // 
+        uint32_t IngestTagged(const uint32_t *ids, const uint8_t *samples,
+                              uint32_t count, Debouncer *ports) const;
+
+        // 
+        // Ingest Tagged
+        // Description:
+        //      Looks up the slot of each sample's ID and stores the sample
+        //      at that slot of a status array, ready to be passed to the
+        //      ButtonProcess of a bank.
+        // Parameters:
+        //      ids - The ID of the device each sample came from.
+        //      samples - The port statuses.
+        //      count - The number of samples.
+        //      portStatus - The status array, indexed by slot.
+        // Returns:
+        //      The number of samples whose ID wasn't in the index.
+        // 
+        uint32_t IngestTagged(const uint32_t *ids, const uint8_t *samples,
+                              uint32_t count, uint8_t *portStatus) const;
+
+        // 
+        // Size
+        // Description:
+        //      Gets the number of IDs in the index.
+        // 
+        uint32_t Size() const;
+
+    private:
+        DebouncerIdIndex(const DebouncerIdIndex &);
+        DebouncerIdIndex &operator=(const DebouncerIdIndex &);
+
+        // 
+        // A table position. Empty positions have a slot of
+        // BUTTON_INDEX_NOT_FOUND.
+        // 
+        struct
+        Entry
+        {
+            uint32_t id;
+            uint32_t slot;
+        };
+
+        // 
+        // Gets the position an ID would ideally be at
+        // 
+        uint32_t Home(uint32_t id) const;
+
+        // 
+        // Gets how far the entry at a position is from its home position
+        // 
+        uint32_t Distance(uint32_t position) const;
+
+        Entry *table;
+        DebouncerArena *arena;
+        uint32_t mask;
+        uint32_t shift;
+        uint32_t size;
+        uint32_t maxIds;
+};
+
+#endif  // BUTTON_DEBOUNCER_INDEX_H
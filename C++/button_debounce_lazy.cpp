@@ -0,0 +1,274 @@
+//*********************************************************************************
+// State Button Debouncer - Lazy Bank
+// 
+// Revision: 1.0
+// 
+// Description: Stores samples on the sampling path and debounces ports only
+// when they are queried. See button_debounce_lazy.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <string.h>
+#include "button_debounce_lazy.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// The number of ports Evaluate debounces together
+#define BUTTON_LAZY_BLOCK_PORTS     64
+
+//*********************************************************************************
+// Class Functions
+//*********************************************************************************
+LazyDebouncerBank::
+LazyDebouncerBank(uint32_t numPorts, uint32_t depth, uint8_t pulledUpButtons,
+                  DebouncerArena *arena)
+{
+    uint32_t port;
+
+    this->numPorts = numPorts;
+    this->arena = arena;
+    this->depth = depth < NUM_BUTTON_STATES ? NUM_BUTTON_STATES : depth;
+    head = 0;
+
+    // Samples from before the first call to ButtonProcess read as
+    // released, just like the state array of a new Debouncer
+    samples = DebouncerAllocate<uint8_t>(arena, (size_t)this->depth * numPorts);
+    memset(samples, 0x00, (size_t)this->depth * numPorts);
+
+    evaluated = DebouncerAllocate<uint64_t>(arena, numPorts);
+    debouncedState = DebouncerAllocate<uint8_t>(arena, numPorts);
+    pullType = DebouncerAllocate<uint8_t>(arena, numPorts);
+    pressed = DebouncerAllocate<uint8_t>(arena, numPorts);
+    released = DebouncerAllocate<uint8_t>(arena, numPorts);
+
+    for(port = 0; port < numPorts; port++)
+    {
+        evaluated[port] = 0;
+    }
+    memset(debouncedState, 0x00, numPorts);
+    memset(pullType, pulledUpButtons, numPorts);
+    memset(pressed, 0x00, numPorts);
+    memset(released, 0x00, numPorts);
+}
+
+LazyDebouncerBank::
+~LazyDebouncerBank()
+{
+    DebouncerFree(arena, samples, (size_t)depth * numPorts);
+    DebouncerFree(arena, evaluated, numPorts);
+    DebouncerFree(arena, debouncedState, numPorts);
+    DebouncerFree(arena, pullType, numPorts);
+    DebouncerFree(arena, pressed, numPorts);
+    DebouncerFree(arena, released, numPorts);
+}
+
+void LazyDebouncerBank::
+SetPullType(uint32_t port, uint8_t pulledUpButtons)
+{
+    pullType[port] = pulledUpButtons;
+}
+
+void LazyDebouncerBank::
+ButtonProcess(const uint8_t *portStatus)
+{
+    uint8_t *row = samples + (size_t)(head % depth) * numPorts;
+    uint32_t port;
+
+    for(port = 0; port < numPorts; port++)
+    {
+        row[port] = portStatus[port] ^ pullType[port];
+    }
+
+    head++;
+}
+
+uint64_t LazyDebouncerBank::
+FirstPending(uint64_t from) const
+{
+    // Debouncing sample t needs samples t - NUM_BUTTON_STATES + 1 up to t,
+    // so only the last depth - NUM_BUTTON_STATES + 1 samples can be
+    // debounced
+    if(head - from > depth - NUM_BUTTON_STATES + 1)
+    {
+        return head - (depth - NUM_BUTTON_STATES + 1);
+    }
+
+    return from;
+}
+
+void LazyDebouncerBank::
+CatchUp(uint32_t port)
+{
+    uint64_t t;
+    uint8_t debounced;
+    uint8_t changed;
+    uint8_t j;
+
+    for(t = FirstPending(evaluated[port]); t < head; t++)
+    {
+        // Rows of samples from before the first one still hold 0 since
+        // their turn to be written hasn't come yet
+        debounced = 0xFF;
+        for(j = 0; j < NUM_BUTTON_STATES; j++)
+        {
+            debounced &= samples[(size_t)((t + depth - j) % depth) * numPorts + port];
+        }
+
+        changed = debounced ^ debouncedState[port];
+        pressed[port] |= changed & debounced;
+        released[port] |= changed & ~debounced;
+        debouncedState[port] = debounced;
+    }
+
+    evaluated[port] = head;
+}
+
+void LazyDebouncerBank::
+Evaluate(uint32_t firstPort, uint32_t rangePorts)
+{
+    uint8_t debounced[BUTTON_LAZY_BLOCK_PORTS];
+    uint8_t changed;
+    const uint8_t *row;
+    uint64_t from;
+    uint64_t t;
+    uint32_t port;
+    uint32_t count;
+    uint32_t i;
+    uint8_t j;
+
+    for(port = firstPort; port < firstPort + rangePorts; port += count)
+    {
+        count = firstPort + rangePorts - port;
+        if(count > BUTTON_LAZY_BLOCK_PORTS)
+        {
+            count = BUTTON_LAZY_BLOCK_PORTS;
+        }
+
+        // A block can only be debounced together when all of its ports are
+        // waiting on the same samples. Otherwise catch them up one by one.
+        from = evaluated[port];
+        for(i = 1; i < count; i++)
+        {
+            if(evaluated[port + i] != from)
+            {
+                break;
+            }
+        }
+        if(i < count)
+        {
+            for(i = 0; i < count; i++)
+            {
+                CatchUp(port + i);
+            }
+            continue;
+        }
+
+        for(t = FirstPending(from); t < head; t++)
+        {
+            for(i = 0; i < count; i++)
+            {
+                debounced[i] = 0xFF;
+            }
+            for(j = 0; j < NUM_BUTTON_STATES; j++)
+            {
+                row = samples + (size_t)((t + depth - j) % depth) * numPorts + port;
+                for(i = 0; i < count; i++)
+                {
+                    debounced[i] &= row[i];
+                }
+            }
+
+            for(i = 0; i < count; i++)
+            {
+                changed = debounced[i] ^ debouncedState[port + i];
+                pressed[port + i] |= changed & debounced[i];
+                released[port + i] |= changed & ~debounced[i];
+                debouncedState[port + i] = debounced[i];
+            }
+        }
+
+        for(i = 0; i < count; i++)
+        {
+            evaluated[port + i] = head;
+        }
+    }
+}
+
+uint8_t LazyDebouncerBank::
+ButtonPressed(uint32_t port, uint8_t GPIOButtonPins)
+{
+    uint8_t pins;
+
+    CatchUp(port);
+    pins = pressed[port] & GPIOButtonPins;
+    pressed[port] &= ~pins;
+
+    return pins;
+}
+
+uint8_t LazyDebouncerBank::
+ButtonReleased(uint32_t port, uint8_t GPIOButtonPins)
+{
+    uint8_t pins;
+
+    CatchUp(port);
+    pins = released[port] & GPIOButtonPins;
+    released[port] &= ~pins;
+
+    return pins;
+}
+
+uint8_t LazyDebouncerBank::
+ButtonCurrent(uint32_t port, uint8_t GPIOButtonPins)
+{
+    CatchUp(port);
+
+    return debouncedState[port] & GPIOButtonPins;
+}
+
+uint32_t LazyDebouncerBank::
+NumPorts() const
+{
+    return numPorts;
+}
+
+uint32_t LazyDebouncerBank::
+Depth() const
+{
+    return depth;
+}
+
+uint64_t LazyDebouncerBank::
+Ticks() const
+{
+    return head;
+}
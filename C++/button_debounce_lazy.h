@@ -0,0 +1,198 @@
+//*********************************************************************************
+// State Button Debouncer - Lazy Bank
+// 
+// Revision: 1.0
+// 
+// Description: Moves the cost of debouncing from the sampling path to the
+// ports that are actually queried. ButtonProcess only copies the port
+// statuses into a ring of the last few samples. A port is debounced when it
+// is queried, working through every sample it has received since it was last
+// looked at. Ports that are never queried are never debounced.
+// 
+// The ring holds depth samples. A port that isn't queried for more than
+// depth - NUM_BUTTON_STATES + 1 samples is debounced starting from the oldest
+// sample still in the ring. Its debounced state is still right but presses
+// and releases that came and went in the samples that were dropped are lost.
+// 
+// Since queries debounce, they change the bank and a bank must only be used
+// by one thread at a time.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_LAZY_H
+#define BUTTON_DEBOUNCER_LAZY_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include "button_debounce.h"
+#include "button_debounce_arena.h"
+
+//*********************************************************************************
+// Class
+//*********************************************************************************
+
+class
+LazyDebouncerBank
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Initializes a bank of released ports.
+        // Parameters:
+        //      numPorts - The number of ports in the bank.
+        //      depth - The number of samples kept per port. Values below
+        //          NUM_BUTTON_STATES are raised to NUM_BUTTON_STATES.
+        //      pulledUpButtons - The pullups used on every port. See the
+        //          Debouncer constructor.
+        //      arena - Where to allocate the bank from, or NULL for the
+        //          heap.
+        // Returns:
+        //      None
+        // 
+        LazyDebouncerBank(uint32_t numPorts, uint32_t depth, uint8_t pulledUpButtons,
+                          DebouncerArena *arena = NULL);
+        ~LazyDebouncerBank();
+
+        // 
+        // Set Pull Type
+        // Description:
+        //      Changes the pullups used on one port from the next sample on.
+        // 
+        void SetPullType(uint32_t port, uint8_t pulledUpButtons);
+
+        // 
+        // Button Process
+        // Description:
+        //      Stores one sample of every port without debouncing anything.
+        //      Should be called on a regular interval by the application.
+        // Parameters:
+        //      portStatus - An array holding one status byte per port.
+        // Returns:
+        //      None
+        // 
+        void ButtonProcess(const uint8_t *portStatus);
+
+        // 
+        // Evaluate
+        // Description:
+        //      Debounces a range of ports up to the latest sample. Queries do
+        //      this on their own one port at a time. Evaluating a range in
+        //      one go is faster when many neighbouring ports are about to be
+        //      read, since ports that were last evaluated at the same sample
+        //      are debounced together.
+        // Parameters:
+        //      firstPort - The index of the first port in the range.
+        //      rangePorts - The number of ports in the range.
+        // Returns:
+        //      None
+        // 
+        void Evaluate(uint32_t firstPort, uint32_t rangePorts);
+
+        // 
+        // Button Pressed and Button Released
+        // Description:
+        //      Gets the pins of a port that were pressed or released since
+        //      they were last asked about. The pins returned are cleared, so
+        //      every press and release is reported once.
+        // Parameters:
+        //      port - The port's index in the bank.
+        //      GPIOButtonPins - The ORed combination of BUTTON_PIN_*.
+        // Returns:
+        //      The pins that were pressed or released.
+        // 
+        uint8_t ButtonPressed(uint32_t port, uint8_t GPIOButtonPins);
+        uint8_t ButtonReleased(uint32_t port, uint8_t GPIOButtonPins);
+
+        // 
+        // Button Current
+        // Description:
+        //      Same as the Debouncer function of the same name for one port.
+        // 
+        uint8_t ButtonCurrent(uint32_t port, uint8_t GPIOButtonPins);
+
+        // 
+        // Num Ports, Depth and Ticks
+        // Description:
+        //      Get the number of ports, the number of samples kept per port
+        //      and the number of calls to ButtonProcess so far.
+        // 
+        uint32_t NumPorts() const;
+        uint32_t Depth() const;
+        uint64_t Ticks() const;
+
+    private:
+        LazyDebouncerBank(const LazyDebouncerBank &);
+        LazyDebouncerBank &operator=(const LazyDebouncerBank &);
+
+        // 
+        // Gets the first sample a port last evaluated at sample from must
+        // still be debounced for
+        // 
+        uint64_t FirstPending(uint64_t from) const;
+
+        // 
+        // Debounces one port up to the latest sample
+        // 
+        void CatchUp(uint32_t port);
+
+        uint32_t numPorts;
+        uint32_t depth;
+        DebouncerArena *arena;
+
+        // 
+        // depth rows of numPorts samples. Sample number t of every port is
+        // in row t % depth with the pins that are pulled up already flipped.
+        // 
+        uint8_t *samples;
+
+        // 
+        // The number of samples stored so far
+        // 
+        uint64_t head;
+
+        // 
+        // The number of samples each port has been debounced for
+        // 
+        uint64_t *evaluated;
+
+        // 
+        // The debounced state, pull type and the pins pressed and released
+        // since last asked about, of every port
+        // 
+        uint8_t *debouncedState;
+        uint8_t *pullType;
+        uint8_t *pressed;
+        uint8_t *released;
+};
+
+#endif  // BUTTON_DEBOUNCER_LAZY_H
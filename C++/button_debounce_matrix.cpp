@@ -0,0 +1,278 @@
+//*********************************************************************************
+// State Button Debouncer - Key Matrix
+// 
+// Revision: 1.0
+// 
+// Description: Debounces a scanned key matrix. See button_debounce_matrix.h
+// for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <string.h>
+#include "button_debounce_matrix.h"
+
+//*********************************************************************************
+// Class Functions
+//*********************************************************************************
+MatrixDebouncer::
+MatrixDebouncer(uint32_t numRows, uint8_t numColumns, uint64_t pulledUpColumns,
+                uint32_t maxKeys, DebouncerArena *arena)
+{
+    this->numRows = numRows;
+    this->maxKeys = maxKeys;
+    this->arena = arena;
+    columnMask = numColumns >= BUTTON_MATRIX_MAX_COLUMNS ? ~(uint64_t)0 :
+                 ((uint64_t)1 << numColumns) - 1;
+    pullType = pulledUpColumns & columnMask;
+    scanRow = 0;
+    index = 0;
+
+    state = DebouncerAllocate<uint64_t>(arena, (size_t)numRows * NUM_BUTTON_STATES);
+    debouncedState = DebouncerAllocate<uint64_t>(arena, numRows);
+    changed = DebouncerAllocate<uint64_t>(arena, numRows);
+    candidate = DebouncerAllocate<uint64_t>(arena, numRows);
+    activeRows = DebouncerAllocate<uint32_t>(arena, numRows);
+    ghostRows = DebouncerAllocate<uint8_t>(arena, numRows);
+
+    memset(state, 0x00, sizeof(uint64_t) * numRows * NUM_BUTTON_STATES);
+    memset(debouncedState, 0x00, sizeof(uint64_t) * numRows);
+    memset(changed, 0x00, sizeof(uint64_t) * numRows);
+    memset(ghostRows, 0x00, numRows);
+
+    keysDown = 0;
+    ghosting = false;
+    rolloverExceeded = false;
+    eventRow = numRows;
+    eventBits = 0;
+}
+
+MatrixDebouncer::
+~MatrixDebouncer()
+{
+    DebouncerFree(arena, state, (size_t)numRows * NUM_BUTTON_STATES);
+    DebouncerFree(arena, debouncedState, numRows);
+    DebouncerFree(arena, changed, numRows);
+    DebouncerFree(arena, candidate, numRows);
+    DebouncerFree(arena, activeRows, numRows);
+    DebouncerFree(arena, ghostRows, numRows);
+}
+
+uint32_t MatrixDebouncer::
+CurrentRow() const
+{
+    return scanRow;
+}
+
+bool MatrixDebouncer::
+ScanRow(uint64_t columns)
+{
+    // Save the reading, flipping the pulled up columns so that a 1 bit
+    // always means pressed
+    state[(size_t)numRows * index + scanRow] = (columns & columnMask) ^ pullType;
+
+    scanRow++;
+    if(scanRow < numRows)
+    {
+        return false;
+    }
+
+    scanRow = 0;
+    Debounce();
+
+    // Check to make sure the index hasn't gone over the limit
+    index++;
+    if(index >= NUM_BUTTON_STATES)
+    {
+        index = 0;
+    }
+
+    return true;
+}
+
+void MatrixDebouncer::
+Debounce()
+{
+    uint64_t keys;
+    uint64_t common;
+    uint64_t presses;
+    uint64_t bit;
+    uint32_t numActive = 0;
+    uint32_t row;
+    uint32_t i;
+    uint32_t j;
+
+    // A key is down once it has been down in every sample
+    for(row = 0; row < numRows; row++)
+    {
+        keys = columnMask;
+        for(i = 0; i < NUM_BUTTON_STATES; i++)
+        {
+            keys &= state[(size_t)numRows * i + row];
+        }
+
+        candidate[row] = keys;
+        if(keys != 0)
+        {
+            activeRows[numActive++] = row;
+        }
+    }
+
+    // Two rows sharing two pressed columns form a rectangle, one corner of
+    // which may be a ghost. Only rows with keys down can take part, and
+    // usually there are only a few of them.
+    for(i = 0; i < numActive; i++)
+    {
+        for(j = i + 1; j < numActive; j++)
+        {
+            common = candidate[activeRows[i]] & candidate[activeRows[j]];
+            if((common & (common - 1)) != 0)
+            {
+                ghostRows[activeRows[i]] = 1;
+                ghostRows[activeRows[j]] = 1;
+            }
+        }
+    }
+
+    // Keys that stay down count against the rollover limit before any new
+    // presses are let in
+    keysDown = 0;
+    for(i = 0; i < numActive; i++)
+    {
+        row = activeRows[i];
+        keysDown += __builtin_popcountll(candidate[row] & debouncedState[row]);
+    }
+
+    ghosting = false;
+    rolloverExceeded = false;
+    for(row = 0; row < numRows; row++)
+    {
+        keys = candidate[row] & debouncedState[row];
+        presses = candidate[row] & ~debouncedState[row];
+
+        if(ghostRows[row])
+        {
+            ghostRows[row] = 0;
+            if(presses != 0)
+            {
+                ghosting = true;
+                presses = 0;
+            }
+        }
+
+        if(maxKeys == BUTTON_MATRIX_NO_LIMIT)
+        {
+            keys |= presses;
+            keysDown += __builtin_popcountll(presses);
+        }
+        else
+        {
+            // Let presses in lowest column first while there is room
+            while(presses != 0 && keysDown < maxKeys)
+            {
+                bit = presses & (~presses + 1);
+                presses &= presses - 1;
+                keys |= bit;
+                keysDown++;
+            }
+            if(presses != 0)
+            {
+                rolloverExceeded = true;
+            }
+        }
+
+        changed[row] = keys ^ debouncedState[row];
+        debouncedState[row] = keys;
+    }
+
+    // Start a new set of events
+    eventRow = 0;
+    eventBits = numRows != 0 ? changed[0] : 0;
+}
+
+bool MatrixDebouncer::
+NextEvent(MatrixKeyEvent &event)
+{
+    uint8_t column;
+
+    if(eventRow >= numRows)
+    {
+        return false;
+    }
+
+    // Skip rows without changes a whole word at a time
+    while(eventBits == 0)
+    {
+        eventRow++;
+        if(eventRow >= numRows)
+        {
+            return false;
+        }
+        eventBits = changed[eventRow];
+    }
+
+    column = (uint8_t)__builtin_ctzll(eventBits);
+    eventBits &= eventBits - 1;
+
+    event.row = eventRow;
+    event.column = column;
+    event.pressed = ((debouncedState[eventRow] >> column) & 1) != 0;
+
+    return true;
+}
+
+bool MatrixDebouncer::
+KeyDown(uint32_t row, uint8_t column) const
+{
+    return ((debouncedState[row] >> column) & 1) != 0;
+}
+
+uint64_t MatrixDebouncer::
+RowState(uint32_t row) const
+{
+    return debouncedState[row];
+}
+
+uint32_t MatrixDebouncer::
+KeysDown() const
+{
+    return keysDown;
+}
+
+bool MatrixDebouncer::
+Ghosting() const
+{
+    return ghosting;
+}
+
+bool MatrixDebouncer::
+RolloverExceeded() const
+{
+    return rolloverExceeded;
+}
@@ -0,0 +1,227 @@
+//*********************************************************************************
+// State Button Debouncer - Key Matrix
+// 
+// Revision: 1.0
+// 
+// Description: Debounces a scanned key matrix of up to 64 columns and any
+// number of rows. The application drives one row at a time, reads the
+// columns and hands the reading to ScanRow. Once every row has been read,
+// the whole matrix is debounced at once with each row held as one 64 bit
+// word, so one AND debounces every key of a row.
+// 
+// Matrices without a diode per key show ghost keys: when three keys on the
+// corners of a rectangle are down, the fourth corner reads as down too. A
+// frame where two rows share two or more pressed columns can't be told apart
+// from a ghost, so new presses in those rows are held back until the
+// ambiguity clears. Releases always go through. An optional rollover limit
+// caps the number of keys that can be down at once, holding back further
+// presses the same way.
+// 
+// Changes are read back as events, visited with the lowest row and column
+// first.
+// 
+// Requires C++11.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_MATRIX_H
+#define BUTTON_DEBOUNCER_MATRIX_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include "button_debounce.h"
+#include "button_debounce_arena.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// The most columns a matrix can have
+#define BUTTON_MATRIX_MAX_COLUMNS   64
+
+// Pass as maxKeys to allow any number of keys down at once
+#define BUTTON_MATRIX_NO_LIMIT      0
+
+// 
+// A key that was just pressed or released
+// 
+struct
+MatrixKeyEvent
+{
+    uint32_t row;
+    uint8_t column;
+    bool pressed;
+};
+
+//*********************************************************************************
+// Class
+//*********************************************************************************
+
+class
+MatrixDebouncer
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Initializes a matrix with every key released. Scanning starts
+        //      with row 0.
+        // Parameters:
+        //      numRows - The number of rows.
+        //      numColumns - The number of columns, up to
+        //          BUTTON_MATRIX_MAX_COLUMNS.
+        //      pulledUpColumns - One bit per column that reads 1 when no key
+        //          is pressed. Usually all columns or none.
+        //      maxKeys - The most keys that may be down at once, or
+        //          BUTTON_MATRIX_NO_LIMIT.
+        //      arena - Where to allocate the matrix from, or NULL for the
+        //          heap.
+        // Returns:
+        //      None
+        // 
+        MatrixDebouncer(uint32_t numRows, uint8_t numColumns, uint64_t pulledUpColumns,
+                        uint32_t maxKeys, DebouncerArena *arena = NULL);
+        ~MatrixDebouncer();
+
+        // 
+        // Current Row
+        // Description:
+        //      Gets the row whose reading ScanRow expects next, which is the
+        //      row the application should drive.
+        // 
+        uint32_t CurrentRow() const;
+
+        // 
+        // Scan Row
+        // Description:
+        //      Saves the column reading of the current row and moves on to
+        //      the next row. After the last row the whole matrix is debounced,
+        //      which starts a new set of events, and scanning starts over at
+        //      row 0. Should be called on a regular interval.
+        // Parameters:
+        //      columns - The column reading, column 0 in bit 0.
+        // Returns:
+        //      True if the reading finished a frame and the matrix was
+        //      debounced.
+        // 
+        bool ScanRow(uint64_t columns);
+
+        // 
+        // Next Event
+        // Description:
+        //      Gets the next key that changed in the last debounced frame.
+        // Parameters:
+        //      event - Filled in with the key.
+        // Returns:
+        //      False once every change has been visited.
+        // 
+        bool NextEvent(MatrixKeyEvent &event);
+
+        // 
+        // Key Down and Row State
+        // Description:
+        //      Get the debounced state of one key, and of every key of a row
+        //      with column 0 in bit 0.
+        // 
+        bool KeyDown(uint32_t row, uint8_t column) const;
+        uint64_t RowState(uint32_t row) const;
+
+        // 
+        // Keys Down
+        // Description:
+        //      Gets the number of keys debounced as down.
+        // 
+        uint32_t KeysDown() const;
+
+        // 
+        // Ghosting and Rollover Exceeded
+        // Description:
+        //      Check whether the last frame held back presses because of
+        //      possible ghost keys or because of the rollover limit.
+        // 
+        bool Ghosting() const;
+        bool RolloverExceeded() const;
+
+    private:
+        MatrixDebouncer(const MatrixDebouncer &);
+        MatrixDebouncer &operator=(const MatrixDebouncer &);
+
+        // 
+        // Debounces the frame that was just scanned
+        // 
+        void Debounce();
+
+        uint32_t numRows;
+        uint64_t columnMask;
+        uint64_t pullType;
+        uint32_t maxKeys;
+        DebouncerArena *arena;
+
+        // 
+        // The row being scanned and the state array it goes into
+        // 
+        uint32_t scanRow;
+        uint8_t index;
+
+        // 
+        // NUM_BUTTON_STATES arrays of one word per row, with the pulled up
+        // columns flipped so that a 1 bit always means pressed
+        // 
+        uint64_t *state;
+
+        // 
+        // The debounced keys and the keys that just changed, one word per
+        // row
+        // 
+        uint64_t *debouncedState;
+        uint64_t *changed;
+
+        // 
+        // Scratch space for Debounce: the keys down in every sample, the
+        // rows with any of them and the rows that may hold ghost keys
+        // 
+        uint64_t *candidate;
+        uint32_t *activeRows;
+        uint8_t *ghostRows;
+
+        uint32_t keysDown;
+        bool ghosting;
+        bool rolloverExceeded;
+
+        // 
+        // Where NextEvent is up to
+        // 
+        uint32_t eventRow;
+        uint64_t eventBits;
+};
+
+#endif  // BUTTON_DEBOUNCER_MATRIX_H
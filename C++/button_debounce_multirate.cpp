@@ -0,0 +1,208 @@
+//*********************************************************************************
+// State Button Debouncer - Multi-Rate Engine
+// 
+// Revision: 1.0
+// 
+// Description: Debounces groups of ports that are sampled at different rates.
+// See button_debounce_multirate.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <string.h>
+#include "button_debounce_multirate.h"
+
+//*********************************************************************************
+// Class Functions
+//*********************************************************************************
+MultiRateDebouncerEngine::
+MultiRateDebouncerEngine(uint32_t maxGroups, DebouncerArena *arena)
+{
+    tick = 0;
+    started = false;
+    numGroups = 0;
+    numBatches = 0;
+    this->maxGroups = maxGroups;
+    this->arena = arena;
+
+    groups = DebouncerAllocate<Group>(arena, maxGroups);
+    batches = DebouncerAllocate<Batch>(arena, maxGroups);
+}
+
+MultiRateDebouncerEngine::
+~MultiRateDebouncerEngine()
+{
+    uint32_t i;
+
+    for(i = 0; i < numBatches; i++)
+    {
+        DebouncerDelete(arena, batches[i].bank);
+        DebouncerFree(arena, batches[i].samples, batches[i].numPorts);
+    }
+
+    DebouncerFree(arena, groups, maxGroups);
+    DebouncerFree(arena, batches, maxGroups);
+}
+
+uint32_t MultiRateDebouncerEngine::
+AddGroup(uint32_t numPorts, uint32_t periodTicks, uint8_t pulledUpButtons)
+{
+    Group *group;
+
+    if(started || numGroups >= maxGroups)
+    {
+        return BUTTON_MULTIRATE_INVALID;
+    }
+
+    group = &groups[numGroups];
+    group->numPorts = numPorts;
+    group->period = periodTicks > 0 ? periodTicks : 1;
+    group->pullType = pulledUpButtons;
+    group->batch = 0;
+    group->firstPort = 0;
+
+    return numGroups++;
+}
+
+void MultiRateDebouncerEngine::
+Start()
+{
+    Batch *batch;
+    uint32_t i;
+    uint32_t j;
+    uint32_t port;
+
+    // The groups are already in their batches and the banks are set up
+    if(started)
+    {
+        return;
+    }
+    started = true;
+
+    // Put every group in the batch for its period, after the groups with
+    // the same period that came before it
+    for(i = 0; i < numGroups; i++)
+    {
+        for(j = 0; j < numBatches; j++)
+        {
+            if(batches[j].period == groups[i].period)
+            {
+                break;
+            }
+        }
+
+        if(j == numBatches)
+        {
+            batch = &batches[numBatches++];
+            batch->period = groups[i].period;
+            batch->numPorts = 0;
+            batch->bank = NULL;
+            batch->samples = NULL;
+        }
+
+        groups[i].batch = j;
+        groups[i].firstPort = batches[j].numPorts;
+        batches[j].numPorts += groups[i].numPorts;
+    }
+
+    for(j = 0; j < numBatches; j++)
+    {
+        batches[j].bank = DebouncerNew<DebouncerBank>(arena, batches[j].numPorts,
+                                                      (uint8_t)0x00, arena);
+        batches[j].samples = DebouncerAllocate<uint8_t>(arena, batches[j].numPorts);
+        memset(batches[j].samples, 0x00, batches[j].numPorts);
+    }
+
+    for(i = 0; i < numGroups; i++)
+    {
+        for(port = 0; port < groups[i].numPorts; port++)
+        {
+            batches[groups[i].batch].bank->SetPullType(groups[i].firstPort + port,
+                                                       groups[i].pullType);
+        }
+    }
+}
+
+bool MultiRateDebouncerEngine::
+GroupDue(uint32_t group) const
+{
+    return tick % groups[group].period == 0;
+}
+
+uint8_t *MultiRateDebouncerEngine::
+GroupSamples(uint32_t group)
+{
+    return batches[groups[group].batch].samples + groups[group].firstPort;
+}
+
+void MultiRateDebouncerEngine::
+Tick()
+{
+    uint32_t j;
+
+    for(j = 0; j < numBatches; j++)
+    {
+        if(tick % batches[j].period == 0)
+        {
+            batches[j].bank->ButtonProcess(batches[j].samples);
+        }
+    }
+
+    tick++;
+}
+
+uint8_t MultiRateDebouncerEngine::
+ButtonPressed(uint32_t group, uint32_t port, uint8_t GPIOButtonPins) const
+{
+    const Group &g = groups[group];
+
+    return batches[g.batch].bank->ButtonPressed(g.firstPort + port, GPIOButtonPins);
+}
+
+uint8_t MultiRateDebouncerEngine::
+ButtonReleased(uint32_t group, uint32_t port, uint8_t GPIOButtonPins) const
+{
+    const Group &g = groups[group];
+
+    return batches[g.batch].bank->ButtonReleased(g.firstPort + port, GPIOButtonPins);
+}
+
+uint8_t MultiRateDebouncerEngine::
+ButtonCurrent(uint32_t group, uint32_t port, uint8_t GPIOButtonPins) const
+{
+    const Group &g = groups[group];
+
+    return batches[g.batch].bank->ButtonCurrent(g.firstPort + port, GPIOButtonPins);
+}
+
+uint64_t MultiRateDebouncerEngine::
+Ticks() const
+{
+    return tick;
+}
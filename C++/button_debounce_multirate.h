@@ -0,0 +1,228 @@
+//*********************************************************************************
+// State Button Debouncer - Multi-Rate Engine
+// 
+// Revision: 1.0
+// 
+// Description: Debounces groups of ports that are sampled at different rates.
+// Every group says how often it must be sampled as a number of base ticks, so
+// a base tick of 0.5 milliseconds lets one group be sampled every tick while
+// another is sampled every 20 ticks (10 milliseconds). Groups with the same
+// period are put next to each other in one DebouncerBank, so each tick does
+// one bank pass per period that is due rather than one pass over every port.
+// 
+// The engine is set up with AddGroup and Start. After that, on every base
+// tick, fill in the samples of the groups that are due and call Tick:
+// 
+//      for(group = 0; group < numGroups; group++)
+//      {
+//          if(engine.GroupDue(group))
+//          {
+//              ReadGroup(group, engine.GroupSamples(group));
+//          }
+//      }
+//      engine.Tick();
+// 
+// Requires C++11.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_MULTIRATE_H
+#define BUTTON_DEBOUNCER_MULTIRATE_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include "button_debounce_arena.h"
+#include "button_debounce_bank.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// Never handed out as a group number
+#define BUTTON_MULTIRATE_INVALID    0xFFFFFFFF
+
+//*********************************************************************************
+// Class
+//*********************************************************************************
+
+class
+MultiRateDebouncerEngine
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Initializes an engine without any groups.
+        // Parameters:
+        //      maxGroups - The most groups that can be added.
+        //      arena - Where the group table, and the banks and sample
+        //          buffers set up by Start, are allocated from, or NULL for
+        //          the heap.
+        // Returns:
+        //      None
+        // 
+        MultiRateDebouncerEngine(uint32_t maxGroups, DebouncerArena *arena = NULL);
+        ~MultiRateDebouncerEngine();
+
+        // 
+        // Add Group
+        // Description:
+        //      Adds a group of ports sampled at the same rate. Must be called
+        //      before Start.
+        // Parameters:
+        //      numPorts - The number of ports in the group.
+        //      periodTicks - How often the group is sampled, in base ticks. 1
+        //          means every tick.
+        //      pulledUpButtons - The pullups used on the group's ports.
+        // Returns:
+        //      The group's number, or BUTTON_MULTIRATE_INVALID if maxGroups
+        //      groups have already been added or Start has been called. Groups are numbered from 0 in
+        //      the order they are added.
+        // 
+        uint32_t AddGroup(uint32_t numPorts, uint32_t periodTicks,
+                          uint8_t pulledUpButtons);
+
+        // 
+        // Start
+        // Description:
+        //      Sets up one bank per distinct period once every group has
+        //      been added. Only the first call does anything.
+        // Parameters:
+        //      None
+        // Returns:
+        //      None
+        // 
+        void Start();
+
+        // 
+        // Group Due
+        // Description:
+        //      Checks whether a group is sampled on the next call to Tick.
+        // Parameters:
+        //      group - The group's number.
+        // Returns:
+        //      True if the group's samples must be filled in before Tick.
+        // 
+        bool GroupDue(uint32_t group) const;
+
+        // 
+        // Group Samples
+        // Description:
+        //      Gets where the group's samples go, one status byte per port of
+        //      the group.
+        // Parameters:
+        //      group - The group's number.
+        // Returns:
+        //      The group's sample buffer.
+        // 
+        uint8_t *GroupSamples(uint32_t group);
+
+        // 
+        // Tick
+        // Description:
+        //      Debounces every period that is due and moves on to the next
+        //      base tick. Ports whose period isn't due are left alone and
+        //      keep their presses and releases until they are processed
+        //      again.
+        // Parameters:
+        //      None
+        // Returns:
+        //      None
+        // 
+        void Tick();
+
+        // 
+        // Button Pressed, Button Released and Button Current
+        // Description:
+        //      Same as the DebouncerBank functions of the same name for a port
+        //      of a group.
+        // Parameters:
+        //      group - The group's number.
+        //      port - The port's index within the group.
+        //      GPIOButtonPins - The ORed combination of BUTTON_PIN_*.
+        // 
+        uint8_t ButtonPressed(uint32_t group, uint32_t port, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonReleased(uint32_t group, uint32_t port, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonCurrent(uint32_t group, uint32_t port, uint8_t GPIOButtonPins) const;
+
+        // 
+        // Ticks
+        // Description:
+        //      Gets the number of base ticks so far.
+        // 
+        uint64_t Ticks() const;
+
+    private:
+        MultiRateDebouncerEngine(const MultiRateDebouncerEngine &);
+        MultiRateDebouncerEngine &operator=(const MultiRateDebouncerEngine &);
+
+        struct
+        Group
+        {
+            uint32_t numPorts;
+            uint32_t period;
+            uint8_t pullType;
+
+            // 
+            // The batch the group was put in and its first port there
+            // 
+            uint32_t batch;
+            uint32_t firstPort;
+        };
+
+        // 
+        // All of the ports that share a period
+        // 
+        struct
+        Batch
+        {
+            uint32_t period;
+            uint32_t numPorts;
+            DebouncerBank *bank;
+            uint8_t *samples;
+        };
+
+        // 
+        // There is at most one batch per group, so both tables hold
+        // maxGroups entries
+        // 
+        Group *groups;
+        Batch *batches;
+        uint32_t numGroups;
+        uint32_t numBatches;
+        uint32_t maxGroups;
+        bool started;
+        uint64_t tick;
+        DebouncerArena *arena;
+};
+
+#endif  // BUTTON_DEBOUNCER_MULTIRATE_H
@@ -0,0 +1,293 @@
+//*********************************************************************************
+// State Button Debouncer - Event Notifier
+// 
+// Revision: 1.0
+// 
+// Description: Wakes up consumers waiting on an eventfd when buttons change.
+// See button_debounce_notify.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <sys/eventfd.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include "button_debounce_notify.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// A subscriber's signal state: waiting for a signal, signalled and not yet
+// acknowledged, or signalled and changed again since
+#define BUTTON_NOTIFY_ARMED         0
+#define BUTTON_NOTIFY_SIGNALLED     1
+#define BUTTON_NOTIFY_MISSED        2
+
+//*********************************************************************************
+// Local Functions
+//*********************************************************************************
+
+// 
+// Orders subscriptions by port for the binary searches in Note
+// 
+struct
+SubscriptionPortLess
+{
+    template<typename T>
+    bool operator()(const T &subscription, uint32_t port) const
+    {
+        return subscription.port < port;
+    }
+
+    template<typename T>
+    bool operator()(uint32_t port, const T &subscription) const
+    {
+        return port < subscription.port;
+    }
+};
+
+//*********************************************************************************
+// Class Functions
+//*********************************************************************************
+DebouncerNotifier::
+DebouncerNotifier(uint32_t numPorts, uint32_t maxSubscriptions,
+                  DebouncerArena *arena)
+{
+    uint32_t i;
+
+    this->numPorts = numPorts;
+    this->maxSubscriptions = maxSubscriptions;
+    this->arena = arena;
+    numSubscriptions = 0;
+    numPending = 0;
+    numSubscribers = 0;
+
+    subscriptions = DebouncerAllocate<Subscription>(arena, maxSubscriptions);
+    interestingPins = DebouncerAllocate<uint8_t>(arena, numPorts);
+    memset(interestingPins, 0x00, numPorts);
+
+    for(i = 0; i < BUTTON_NOTIFY_MAX_SUBSCRIBERS; i++)
+    {
+        pending[i] = 0;
+        fds[i] = -1;
+        signalState[i].store(BUTTON_NOTIFY_SIGNALLED, std::memory_order_relaxed);
+    }
+}
+
+DebouncerNotifier::
+~DebouncerNotifier()
+{
+    uint32_t i;
+
+    for(i = 0; i < numSubscribers; i++)
+    {
+        close(fds[i]);
+    }
+
+    DebouncerFree(arena, subscriptions, maxSubscriptions);
+    DebouncerFree(arena, interestingPins, numPorts);
+}
+
+int DebouncerNotifier::
+AddSubscriber()
+{
+    int fd;
+
+    if(numSubscribers >= BUTTON_NOTIFY_MAX_SUBSCRIBERS)
+    {
+        return -1;
+    }
+
+    fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(fd < 0)
+    {
+        return -1;
+    }
+
+    fds[numSubscribers] = fd;
+    signalState[numSubscribers].store(BUTTON_NOTIFY_ARMED, std::memory_order_release);
+
+    return numSubscribers++;
+}
+
+int DebouncerNotifier::
+FileDescriptor(int subscriber) const
+{
+    return fds[subscriber];
+}
+
+bool DebouncerNotifier::
+Subscribe(int subscriber, uint32_t port, uint8_t GPIOButtonPins)
+{
+    Subscription *end = subscriptions + numSubscriptions;
+    Subscription *it;
+
+    if(port >= numPorts)
+    {
+        return false;
+    }
+
+    // Add the pins to an existing subscription for this port if there is
+    // one. Otherwise insert a new one, keeping the list sorted by port.
+    for(it = std::lower_bound(subscriptions, end, port, SubscriptionPortLess());
+        it != end && it->port == port; ++it)
+    {
+        if(it->subscriber == subscriber)
+        {
+            it->pins |= GPIOButtonPins;
+            interestingPins[port] |= GPIOButtonPins;
+            return true;
+        }
+    }
+
+    if(numSubscriptions >= maxSubscriptions)
+    {
+        return false;
+    }
+
+    memmove(it + 1, it, (size_t)(end - it) * sizeof(Subscription));
+    it->port = port;
+    it->pins = GPIOButtonPins;
+    it->subscriber = (uint8_t)subscriber;
+    numSubscriptions++;
+    interestingPins[port] |= GPIOButtonPins;
+
+    return true;
+}
+
+void DebouncerNotifier::
+Note(uint32_t port, uint8_t changedPins)
+{
+    const Subscription *begin = subscriptions;
+    const Subscription *end = subscriptions + numSubscriptions;
+    const Subscription *it;
+
+    // Almost every change is either nothing or uninteresting
+    if(port >= numPorts || (changedPins & interestingPins[port]) == 0)
+    {
+        return;
+    }
+
+    for(it = std::lower_bound(begin, end, port, SubscriptionPortLess());
+        it != end && it->port == port; ++it)
+    {
+        if((changedPins & it->pins) != 0 && !pending[it->subscriber])
+        {
+            pending[it->subscriber] = 1;
+            pendingList[numPending++] = it->subscriber;
+        }
+    }
+}
+
+void DebouncerNotifier::
+Note(uint32_t port, Debouncer &debouncer)
+{
+    Note(port, debouncer.ButtonPressed(0xFF) | debouncer.ButtonReleased(0xFF));
+}
+
+void DebouncerNotifier::
+Note(const DebouncerBank &bank, uint32_t portOffset)
+{
+    const uint8_t *changed = bank.ChangedStates();
+    DebouncerBank::ChangedIterator it(bank, 0);
+    uint32_t port;
+
+    while(it.Next(port))
+    {
+        Note(portOffset + port, changed[port]);
+    }
+}
+
+void DebouncerNotifier::
+Signal(uint8_t subscriber)
+{
+    uint64_t one = 1;
+    uint8_t state = signalState[subscriber].load(std::memory_order_relaxed);
+    uint8_t next;
+    ssize_t written;
+
+    // Only write to subscribers that have dealt with their last signal. The
+    // others are marked so that Acknowledge can tell they missed one.
+    do
+    {
+        next = (state == BUTTON_NOTIFY_ARMED) ? BUTTON_NOTIFY_SIGNALLED :
+                                                BUTTON_NOTIFY_MISSED;
+    }
+    while(!signalState[subscriber].compare_exchange_weak(state, next,
+                                                         std::memory_order_acq_rel));
+
+    if(state == BUTTON_NOTIFY_ARMED)
+    {
+        written = write(fds[subscriber], &one, sizeof(one));
+        (void)written;
+    }
+}
+
+void DebouncerNotifier::
+Flush()
+{
+    uint8_t subscriber;
+    uint32_t i;
+
+    for(i = 0; i < numPending; i++)
+    {
+        subscriber = pendingList[i];
+        pending[subscriber] = 0;
+        Signal(subscriber);
+    }
+
+    numPending = 0;
+}
+
+void DebouncerNotifier::
+Acknowledge(int subscriber)
+{
+    uint64_t count;
+    ssize_t got;
+
+    // Changes flushed before this point are seen when the subscriber looks
+    // at the buttons. Changes flushed from here on mark the subscriber as
+    // having missed a signal.
+    signalState[subscriber].store(BUTTON_NOTIFY_SIGNALLED, std::memory_order_seq_cst);
+
+    // Drain the eventfd before re-arming so that a signal written after
+    // re-arming can't be drained along with the old one
+    got = read(fds[subscriber], &count, sizeof(count));
+    (void)got;
+
+    // A change flushed while draining would otherwise be lost, so signal it
+    // now
+    if(signalState[subscriber].exchange(BUTTON_NOTIFY_ARMED,
+                                        std::memory_order_acq_rel) == BUTTON_NOTIFY_MISSED)
+    {
+        Signal((uint8_t)subscriber);
+    }
+}
@@ -0,0 +1,263 @@
+//*********************************************************************************
+// State Button Debouncer - Event Notifier
+// 
+// Revision: 1.0
+// 
+// Description: Wakes up consumers that are waiting for buttons to change
+// instead of having them poll ButtonPressed. Each subscriber gets a Linux
+// eventfd that it can wait on with poll, select or epoll next to its other
+// file descriptors. The subscriber says which pins of which ports it cares
+// about, and its eventfd becomes readable when one of them changes debounced
+// state.
+// 
+// The producer reports what changed after each ButtonProcess call with Note
+// and calls Flush once the whole batch (for example one tick) has been
+// reported. Flush signals every interested subscriber at most once. A
+// subscriber that hasn't called Acknowledge since its last signal isn't
+// signalled again, so a slow subscriber costs no extra system calls.
+// 
+// Note and Flush must be called from one thread. Acknowledge may be called
+// from any thread. Requires Linux and C++11.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_NOTIFY_H
+#define BUTTON_DEBOUNCER_NOTIFY_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include <atomic>
+#include "button_debounce.h"
+#include "button_debounce_arena.h"
+#include "button_debounce_bank.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// The most subscribers one notifier can have
+#define BUTTON_NOTIFY_MAX_SUBSCRIBERS   64
+
+//*********************************************************************************
+// Class
+//*********************************************************************************
+
+class
+DebouncerNotifier
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Initializes a notifier without subscribers.
+        // Parameters:
+        //      numPorts - The number of ports that will be reported on. Ports
+        //          are numbered from 0 to numPorts - 1.
+        //      maxSubscriptions - The most (subscriber, port) pairs that can
+        //          be subscribed to across all subscribers.
+        //      arena - Where to allocate the notifier's tables from, or NULL
+        //          for the heap.
+        // Returns:
+        //      None
+        // 
+        DebouncerNotifier(uint32_t numPorts, uint32_t maxSubscriptions,
+                          DebouncerArena *arena = NULL);
+
+        // 
+        // Destructor
+        // Description:
+        //      Closes the eventfd of every subscriber and frees the tables.
+        // 
+        ~DebouncerNotifier();
+
+        // 
+        // Add Subscriber
+        // Description:
+        //      Creates a subscriber and its eventfd. The subscriber isn't
+        //      interested in anything until Subscribe is called.
+        // Parameters:
+        //      None
+        // Returns:
+        //      The subscriber's number, or -1 if there is no room for another
+        //      subscriber or the eventfd couldn't be created.
+        // 
+        int AddSubscriber();
+
+        // 
+        // File Descriptor
+        // Description:
+        //      Gets the eventfd to wait on. It is non-blocking and becomes
+        //      readable when the subscriber is signalled.
+        // Parameters:
+        //      subscriber - The value returned by AddSubscriber.
+        // Returns:
+        //      The file descriptor. It stays owned by the notifier.
+        // 
+        int FileDescriptor(int subscriber) const;
+
+        // 
+        // Subscribe
+        // Description:
+        //      Adds pins of a port to what a subscriber is interested in. Must
+        //      not be called while Note or Flush may be running.
+        // Parameters:
+        //      subscriber - The value returned by AddSubscriber.
+        //      port - The port.
+        //      GPIOButtonPins - The ORed combination of BUTTON_PIN_*.
+        // Returns:
+        //      False if the port is out of range or a new subscription was
+        //      needed and maxSubscriptions have already been made. True
+        //      otherwise.
+        // 
+        bool Subscribe(int subscriber, uint32_t port, uint8_t GPIOButtonPins);
+
+        // 
+        // Note
+        // Description:
+        //      Reports the pins of a port that just changed debounced state.
+        //      Nobody is woken up before Flush.
+        // Parameters:
+        //      port - The port.
+        //      changedPins - The pins that changed.
+        // Returns:
+        //      None
+        // 
+        void Note(uint32_t port, uint8_t changedPins);
+
+        // 
+        // Note
+        // Description:
+        //      Reports what the last ButtonProcess call on a Debouncer
+        //      changed.
+        // Parameters:
+        //      port - The port the Debouncer debounces.
+        //      debouncer - The Debouncer instantiation.
+        // Returns:
+        //      None
+        // 
+        void Note(uint32_t port, Debouncer &debouncer);
+
+        // 
+        // Note
+        // Description:
+        //      Reports what the last ButtonProcess call on a bank changed.
+        //      Bank port i is reported as port portOffset + i.
+        // Parameters:
+        //      bank - The bank.
+        //      portOffset - The port number of the bank's first port.
+        // Returns:
+        //      None
+        // 
+        void Note(const DebouncerBank &bank, uint32_t portOffset);
+
+        // 
+        // Flush
+        // Description:
+        //      Signals every subscriber that was interested in something
+        //      reported since the last Flush and has acknowledged its last
+        //      signal.
+        // Parameters:
+        //      None
+        // Returns:
+        //      None
+        // 
+        void Flush();
+
+        // 
+        // Acknowledge
+        // Description:
+        //      Called by a subscriber after it has been woken up and before it
+        //      looks at the buttons. Clears the eventfd and allows the
+        //      subscriber to be signalled again.
+        // Parameters:
+        //      subscriber - The value returned by AddSubscriber.
+        // Returns:
+        //      None
+        // 
+        void Acknowledge(int subscriber);
+
+    private:
+        DebouncerNotifier(const DebouncerNotifier &);
+        DebouncerNotifier &operator=(const DebouncerNotifier &);
+
+        // 
+        // One subscriber's interest in some pins of one port
+        // 
+        struct
+        Subscription
+        {
+            uint32_t port;
+            uint8_t pins;
+            uint8_t subscriber;
+        };
+
+        // 
+        // Subscriptions sorted by port
+        // 
+        Subscription *subscriptions;
+        uint32_t numSubscriptions;
+        uint32_t maxSubscriptions;
+
+        // 
+        // All of the pins of each port that anybody is interested in, so
+        // that uninteresting changes are thrown out with one lookup
+        // 
+        uint8_t *interestingPins;
+        uint32_t numPorts;
+
+        // 
+        // Where the tables came from
+        // 
+        DebouncerArena *arena;
+
+        // 
+        // The subscribers to signal on the next Flush
+        // 
+        uint8_t pending[BUTTON_NOTIFY_MAX_SUBSCRIBERS];
+        uint8_t pendingList[BUTTON_NOTIFY_MAX_SUBSCRIBERS];
+        uint32_t numPending;
+
+        // 
+        // Signals a subscriber if it is armed, or notes that it missed a
+        // signal if it isn't
+        // 
+        void Signal(uint8_t subscriber);
+
+        // 
+        // Each subscriber's eventfd and whether it may be signalled
+        // 
+        int fds[BUTTON_NOTIFY_MAX_SUBSCRIBERS];
+        std::atomic<uint8_t> signalState[BUTTON_NOTIFY_MAX_SUBSCRIBERS];
+        uint32_t numSubscribers;
+};
+
+#endif  // BUTTON_DEBOUNCER_NOTIFY_H
@@ -0,0 +1,377 @@
+//*********************************************************************************
+// State Button Debouncer - Partitioned Bank
+// 
+// Revision: 1.0
+// 
+// Description: Lets several threads feed one large set of ports without
+// locks. See button_debounce_partition.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stddef.h>
+#include "button_debounce_partition.h"
+
+//*********************************************************************************
+// Partition Functions
+//*********************************************************************************
+DebouncerPartition::
+DebouncerPartition(uint32_t firstPort, uint32_t numPorts, uint8_t pulledUpButtons,
+                   uint32_t eventCapacity, DebouncerArena *arena) :
+    bank(numPorts, pulledUpButtons, arena),
+    events(eventCapacity, BUTTON_BROADCAST_OVERWRITE, arena)
+{
+    this->firstPort = firstPort;
+    this->arena = arena;
+    lock.Init();
+    claimed.store(false, std::memory_order_relaxed);
+}
+
+void DebouncerPartition::
+ButtonProcess(const uint8_t *portStatus)
+{
+    lock.WriteBegin();
+    bank.ButtonProcess(portStatus);
+    lock.WriteEnd();
+
+    // An overwriting ring takes every event, so this never stops early
+    events.Publish(bank, 0, firstPort);
+}
+
+void DebouncerPartition::
+SetPullType(uint32_t port, uint8_t pulledUpButtons)
+{
+    lock.WriteBegin();
+    bank.SetPullType(port, pulledUpButtons);
+    lock.WriteEnd();
+}
+
+uint32_t DebouncerPartition::
+FirstPort() const
+{
+    return firstPort;
+}
+
+uint32_t DebouncerPartition::
+NumPorts() const
+{
+    return bank.NumPorts();
+}
+
+//*********************************************************************************
+// Bank Functions
+//*********************************************************************************
+PartitionedDebouncerBank::
+PartitionedDebouncerBank(uint32_t numPartitions, const uint32_t *partitionPorts,
+                         uint8_t pulledUpButtons, uint32_t eventCapacity,
+                         DebouncerArena *arena)
+{
+    this->numPartitions = numPartitions;
+    this->arena = arena;
+    Build(partitionPorts, pulledUpButtons, eventCapacity, NULL, 0);
+}
+
+PartitionedDebouncerBank::
+PartitionedDebouncerBank(uint32_t numPartitions, const uint32_t *partitionPorts,
+                         uint8_t pulledUpButtons, uint32_t eventCapacity,
+                         DebouncerArena *const *partitionArenas, uint32_t numArenas)
+{
+    this->numPartitions = numPartitions;
+    arena = NULL;
+    Build(partitionPorts, pulledUpButtons, eventCapacity, partitionArenas, numArenas);
+}
+
+void PartitionedDebouncerBank::
+Build(const uint32_t *partitionPorts, uint8_t pulledUpButtons, uint32_t eventCapacity,
+      DebouncerArena *const *partitionArenas, uint32_t numArenas)
+{
+    DebouncerArena *partitionArena;
+    void *memory;
+    uint32_t i;
+
+    numPorts = 0;
+    partitions = DebouncerAllocate<DebouncerPartition *>(arena, numPartitions);
+
+    // Each partition is allocated on its own so that no two partitions
+    // share a cache line. The constructor is private to this class so
+    // DebouncerNew can't be used.
+    for(i = 0; i < numPartitions; i++)
+    {
+        partitionArena = numArenas != 0 ? partitionArenas[i % numArenas] : arena;
+
+        memory = NULL;
+        if(partitionArena != NULL)
+        {
+            memory = partitionArena->Allocate(sizeof(DebouncerPartition),
+                                              alignof(DebouncerPartition));
+            if(memory == NULL)
+            {
+                partitionArena->NoteFallback();
+            }
+        }
+
+        // Plain new doesn't honour the partition's cache line alignment
+        // before C++17
+        if(memory == NULL)
+        {
+            memory = DebouncerHeapAllocate(sizeof(DebouncerPartition),
+                                           alignof(DebouncerPartition));
+        }
+
+        partitions[i] = new(memory) DebouncerPartition(numPorts, partitionPorts[i],
+                                                       pulledUpButtons, eventCapacity,
+                                                       partitionArena);
+        numPorts += partitionPorts[i];
+    }
+}
+
+PartitionedDebouncerBank::
+~PartitionedDebouncerBank()
+{
+    uint32_t i;
+
+    for(i = 0; i < numPartitions; i++)
+    {
+        DebouncerDelete(partitions[i]->arena, partitions[i]);
+    }
+    DebouncerFree(arena, partitions, numPartitions);
+}
+
+DebouncerPartition *PartitionedDebouncerBank::
+Claim(uint32_t partition)
+{
+    bool expected = false;
+
+    if(!partitions[partition]->claimed.compare_exchange_strong(expected, true,
+                                                               std::memory_order_acquire))
+    {
+        return NULL;
+    }
+
+    return partitions[partition];
+}
+
+void PartitionedDebouncerBank::
+Release(DebouncerPartition *partition)
+{
+    partition->claimed.store(false, std::memory_order_release);
+}
+
+const DebouncerPartition *PartitionedDebouncerBank::
+Find(uint32_t port) const
+{
+    uint32_t low = 0;
+    uint32_t high;
+    uint32_t middle;
+
+    if(port >= numPorts)
+    {
+        return NULL;
+    }
+
+    high = numPartitions - 1;
+    // Find the last partition starting at or before the port
+    while(low < high)
+    {
+        middle = (low + high + 1) / 2;
+        if(partitions[middle]->firstPort <= port)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle - 1;
+        }
+    }
+
+    return partitions[low];
+}
+
+uint8_t PartitionedDebouncerBank::
+ButtonPressed(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    const DebouncerPartition *partition = Find(port);
+    uint32_t seq;
+    uint8_t pins;
+
+    if(partition == NULL)
+    {
+        return 0;
+    }
+
+    do
+    {
+        seq = partition->lock.ReadBegin();
+        pins = partition->bank.ButtonPressed(port - partition->firstPort,
+                                             GPIOButtonPins);
+    }
+    while(partition->lock.ReadRetry(seq));
+
+    return pins;
+}
+
+uint8_t PartitionedDebouncerBank::
+ButtonReleased(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    const DebouncerPartition *partition = Find(port);
+    uint32_t seq;
+    uint8_t pins;
+
+    if(partition == NULL)
+    {
+        return 0;
+    }
+
+    do
+    {
+        seq = partition->lock.ReadBegin();
+        pins = partition->bank.ButtonReleased(port - partition->firstPort,
+                                              GPIOButtonPins);
+    }
+    while(partition->lock.ReadRetry(seq));
+
+    return pins;
+}
+
+uint8_t PartitionedDebouncerBank::
+ButtonCurrent(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    const DebouncerPartition *partition = Find(port);
+    uint32_t seq;
+    uint8_t pins;
+
+    if(partition == NULL)
+    {
+        return 0;
+    }
+
+    do
+    {
+        seq = partition->lock.ReadBegin();
+        pins = partition->bank.ButtonCurrent(port - partition->firstPort,
+                                             GPIOButtonPins);
+    }
+    while(partition->lock.ReadRetry(seq));
+
+    return pins;
+}
+
+uint32_t PartitionedDebouncerBank::
+NumPorts() const
+{
+    return numPorts;
+}
+
+uint32_t PartitionedDebouncerBank::
+NumPartitions() const
+{
+    return numPartitions;
+}
+
+//*********************************************************************************
+// Event Consumer Functions
+//*********************************************************************************
+PartitionedEventConsumer::
+PartitionedEventConsumer()
+{
+    consumers = NULL;
+    numConsumers = 0;
+    next = 0;
+}
+
+PartitionedEventConsumer::
+~PartitionedEventConsumer()
+{
+    Detach();
+}
+
+bool PartitionedEventConsumer::
+Attach(PartitionedDebouncerBank &bank, uint8_t subscribedPins)
+{
+    uint32_t i;
+
+    Detach();
+
+    numConsumers = bank.numPartitions;
+    consumers = new DebouncerEventConsumer[numConsumers];
+    next = 0;
+
+    for(i = 0; i < numConsumers; i++)
+    {
+        if(!consumers[i].Attach(bank.partitions[i]->events, subscribedPins))
+        {
+            Detach();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void PartitionedEventConsumer::
+Detach()
+{
+    delete[] consumers;
+    consumers = NULL;
+    numConsumers = 0;
+}
+
+bool PartitionedEventConsumer::
+Poll(DebouncerEvent &event)
+{
+    uint32_t i;
+
+    // Start with the partition after the one that gave the last event
+    for(i = 0; i < numConsumers; i++)
+    {
+        if(consumers[next].Poll(event))
+        {
+            next = (next + 1 == numConsumers) ? 0 : next + 1;
+            return true;
+        }
+
+        next = (next + 1 == numConsumers) ? 0 : next + 1;
+    }
+
+    return false;
+}
+
+uint64_t PartitionedEventConsumer::
+Lost() const
+{
+    uint64_t lost = 0;
+    uint32_t i;
+
+    for(i = 0; i < numConsumers; i++)
+    {
+        lost += consumers[i].Lost();
+    }
+
+    return lost;
+}
@@ -0,0 +1,319 @@
+//*********************************************************************************
+// State Button Debouncer - Partitioned Bank
+// 
+// Revision: 1.0
+// 
+// Description: Lets several threads feed one large set of ports without
+// locks. The ports are split into partitions, and each producer thread claims
+// one partition and calls ButtonProcess on it at its own pace. Every
+// partition is a separate DebouncerBank whose arrays start on a cache line of
+// their own, so producers never write to the same cache line.
+// 
+// Other threads see the partitions as one bank: ports are numbered across
+// all partitions, and queries and the event stream cover every partition.
+// Queries are protected by a sequence lock per partition. Events are
+// published into a broadcast ring per partition and merged by
+// PartitionedEventConsumer.
+// 
+// Requires C++17.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_PARTITION_H
+#define BUTTON_DEBOUNCER_PARTITION_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include <atomic>
+#include "button_debounce_bank.h"
+#include "button_debounce_broadcast.h"
+#include "button_debounce_seqlock.h"
+
+//*********************************************************************************
+// Classes
+//*********************************************************************************
+
+class PartitionedDebouncerBank;
+
+// 
+// One partition of a PartitionedDebouncerBank. Only the producer that
+// claimed the partition may call ButtonProcess and SetPullType.
+// 
+class alignas(BUTTON_BANK_ALIGNMENT)
+DebouncerPartition
+{
+    public:
+        // 
+        // Button Process
+        // Description:
+        //      Debounces the partition's ports and publishes the events found
+        //      to the partition's event ring.
+        // Parameters:
+        //      portStatus - One status byte per port of the partition.
+        //          portStatus[0] belongs to the partition's first port.
+        // Returns:
+        //      None
+        // 
+        void ButtonProcess(const uint8_t *portStatus);
+
+        // 
+        // Set Pull Type
+        // Description:
+        //      Changes the pullups of one port of the partition.
+        // Parameters:
+        //      port - The port's index within the partition.
+        //      pulledUpButtons - See the Debouncer constructor.
+        // Returns:
+        //      None
+        // 
+        void SetPullType(uint32_t port, uint8_t pulledUpButtons);
+
+        // 
+        // First Port and Num Ports
+        // Description:
+        //      Gets the global number of the partition's first port and the
+        //      number of ports in the partition.
+        // 
+        uint32_t FirstPort() const;
+        uint32_t NumPorts() const;
+
+    private:
+        friend class PartitionedDebouncerBank;
+        friend class PartitionedEventConsumer;
+
+        DebouncerPartition(uint32_t firstPort, uint32_t numPorts,
+                           uint8_t pulledUpButtons, uint32_t eventCapacity,
+                           DebouncerArena *arena);
+
+        DebouncerPartition(const DebouncerPartition &);
+        DebouncerPartition &operator=(const DebouncerPartition &);
+
+        // 
+        // Written on every tick by the producer. Kept on its own cache line
+        // away from the fields below that the other threads read.
+        // 
+        DebouncerSeqLock lock;
+
+        alignas(BUTTON_BANK_ALIGNMENT) DebouncerBank bank;
+        DebouncerEventRing events;
+        uint32_t firstPort;
+        std::atomic<bool> claimed;
+
+        // 
+        // The arena the partition was allocated from, if any
+        // 
+        DebouncerArena *arena;
+};
+
+class
+PartitionedDebouncerBank
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Initializes the partitions. Partition 0 holds ports 0 to
+        //      partitionPorts[0] - 1, partition 1 the ports after those and
+        //      so on.
+        // Parameters:
+        //      numPartitions - The number of partitions. With no partitions
+        //          every query gives 0.
+        //      partitionPorts - The number of ports in each partition.
+        //      pulledUpButtons - The pullups used on every port.
+        //      eventCapacity - The size of each partition's event ring. Must
+        //          be a power of two. Rings overwrite their oldest events
+        //          when full so that producers never wait on consumers.
+        //      arena - Where to allocate the partitions from, or NULL for
+        //          the heap.
+        // Returns:
+        //      None
+        // 
+        PartitionedDebouncerBank(uint32_t numPartitions,
+                                 const uint32_t *partitionPorts,
+                                 uint8_t pulledUpButtons, uint32_t eventCapacity,
+                                 DebouncerArena *arena = NULL);
+
+        // 
+        // Constructor
+        // Description:
+        //      Same as above but spreads the partitions over several arenas.
+        //      Giving each partition an arena mapped on the NUMA node of the
+        //      thread that processes it keeps each producer's ticks in local
+        //      memory.
+        // Parameters:
+        //      numPartitions - The number of partitions.
+        //      partitionPorts - The number of ports in each partition.
+        //      pulledUpButtons - The pullups used on every port.
+        //      eventCapacity - The size of each partition's event ring.
+        //      partitionArenas - The arenas. Partition i is allocated from
+        //          partitionArenas[i % numArenas], so with one arena per node
+        //          the partitions take turns between the nodes.
+        //      numArenas - The number of arenas. Must not be 0.
+        // Returns:
+        //      None
+        // 
+        PartitionedDebouncerBank(uint32_t numPartitions,
+                                 const uint32_t *partitionPorts,
+                                 uint8_t pulledUpButtons, uint32_t eventCapacity,
+                                 DebouncerArena *const *partitionArenas,
+                                 uint32_t numArenas);
+        ~PartitionedDebouncerBank();
+
+        // 
+        // Claim
+        // Description:
+        //      Gives a producer exclusive use of a partition.
+        // Parameters:
+        //      partition - The partition's number.
+        // Returns:
+        //      The partition, or NULL if it is already claimed.
+        // 
+        DebouncerPartition *Claim(uint32_t partition);
+
+        // 
+        // Release
+        // Description:
+        //      Gives up a claimed partition so that another producer can
+        //      claim it.
+        // Parameters:
+        //      partition - The value returned by Claim.
+        // Returns:
+        //      None
+        // 
+        void Release(DebouncerPartition *partition);
+
+        // 
+        // Button Pressed, Button Released and Button Current
+        // Description:
+        //      Same as the DebouncerBank functions of the same name, for a
+        //      port numbered across all partitions. Safe to call from any
+        //      thread while the producers are processing.
+        // 
+        uint8_t ButtonPressed(uint32_t port, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonReleased(uint32_t port, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonCurrent(uint32_t port, uint8_t GPIOButtonPins) const;
+
+        // 
+        // Num Ports and Num Partitions
+        // Description:
+        //      Gets the total number of ports and the number of partitions.
+        // 
+        uint32_t NumPorts() const;
+        uint32_t NumPartitions() const;
+
+    private:
+        friend class PartitionedEventConsumer;
+
+        PartitionedDebouncerBank(const PartitionedDebouncerBank &);
+        PartitionedDebouncerBank &operator=(const PartitionedDebouncerBank &);
+
+        // 
+        // Finds the partition holding a port. Gives NULL if the port is
+        // out of range.
+        // 
+        const DebouncerPartition *Find(uint32_t port) const;
+
+        // 
+        // Allocates the partitions. Partition i comes from
+        // partitionArenas[i % numArenas] when there are any and from arena
+        // otherwise.
+        // 
+        void Build(const uint32_t *partitionPorts, uint8_t pulledUpButtons,
+                   uint32_t eventCapacity, DebouncerArena *const *partitionArenas,
+                   uint32_t numArenas);
+
+        DebouncerPartition **partitions;
+        uint32_t numPartitions;
+        uint32_t numPorts;
+        DebouncerArena *arena;
+};
+
+class
+PartitionedEventConsumer
+{
+    public:
+        PartitionedEventConsumer();
+        ~PartitionedEventConsumer();
+
+        // 
+        // Attach
+        // Description:
+        //      Starts consuming the events of every partition. See
+        //      DebouncerEventConsumer::Attach.
+        // Parameters:
+        //      bank - The partitioned bank.
+        //      subscribedPins - The ORed BUTTON_PIN_* to get events for.
+        // Returns:
+        //      False if one of the partitions' rings has no room for another
+        //      consumer.
+        // 
+        bool Attach(PartitionedDebouncerBank &bank, uint8_t subscribedPins);
+
+        // 
+        // Detach
+        // Description:
+        //      Stops consuming. Called by the destructor.
+        // 
+        void Detach();
+
+        // 
+        // Poll
+        // Description:
+        //      Gets the next event from any partition. Events of one
+        //      partition come out in order. The partitions take turns so that
+        //      a busy partition can't hide the events of the others. Event
+        //      ports are numbered across all partitions.
+        // Parameters:
+        //      event - Filled in with the event.
+        // Returns:
+        //      True if there was an event.
+        // 
+        bool Poll(DebouncerEvent &event);
+
+        // 
+        // Lost
+        // Description:
+        //      Gets the number of events overwritten before they were read,
+        //      summed over all partitions.
+        // 
+        uint64_t Lost() const;
+
+    private:
+        PartitionedEventConsumer(const PartitionedEventConsumer &);
+        PartitionedEventConsumer &operator=(const PartitionedEventConsumer &);
+
+        DebouncerEventConsumer *consumers;
+        uint32_t numConsumers;
+        uint32_t next;
+};
+
+#endif  // BUTTON_DEBOUNCER_PARTITION_H
@@ -0,0 +1,278 @@
+//*********************************************************************************
+// State Button Debouncer - Profiled Bank
+// 
+// Revision: 1.0
+// 
+// Description: A bank whose ports are configured through shared profiles.
+// See button_debounce_profile.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <string.h>
+#include "button_debounce_profile.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// The number of ports of a run debounced together by ProcessRun
+#define BUTTON_PROFILE_BLOCK_PORTS  64
+
+//*********************************************************************************
+// Class Functions
+//*********************************************************************************
+ProfiledDebouncerBank::
+ProfiledDebouncerBank(uint32_t numPorts, uint32_t maxProfiles,
+                      const DebouncerProfile &defaultProfile, DebouncerArena *arena)
+{
+    this->numPorts = numPorts;
+    this->maxProfiles = maxProfiles;
+    this->arena = arena;
+    index = 0;
+
+    state = DebouncerAllocate<uint8_t>(arena, (size_t)numPorts * NUM_BUTTON_STATES);
+    debouncedState = DebouncerAllocate<uint8_t>(arena, numPorts);
+    changed = DebouncerAllocate<uint8_t>(arena, numPorts);
+    profileOf = DebouncerAllocate<uint16_t>(arena, numPorts);
+    profiles = DebouncerAllocate<DebouncerProfile>(arena, maxProfiles);
+
+    memset(state, 0x00, (size_t)numPorts * NUM_BUTTON_STATES);
+    memset(debouncedState, 0x00, numPorts);
+    memset(changed, 0x00, numPorts);
+    memset(profileOf, 0x00, sizeof(uint16_t) * numPorts);
+
+    // Unlike AddProfile the constructor can't refuse a profile, so an out
+    // of range depth falls back to the full history
+    profiles[0] = defaultProfile;
+    if(profiles[0].depth == 0 || profiles[0].depth > NUM_BUTTON_STATES)
+    {
+        profiles[0].depth = NUM_BUTTON_STATES;
+    }
+    numProfiles = 1;
+}
+
+ProfiledDebouncerBank::
+~ProfiledDebouncerBank()
+{
+    DebouncerFree(arena, state, (size_t)numPorts * NUM_BUTTON_STATES);
+    DebouncerFree(arena, debouncedState, numPorts);
+    DebouncerFree(arena, changed, numPorts);
+    DebouncerFree(arena, profileOf, numPorts);
+    DebouncerFree(arena, profiles, maxProfiles);
+}
+
+uint16_t ProfiledDebouncerBank::
+AddProfile(const DebouncerProfile &profile)
+{
+    uint32_t i;
+
+    if(profile.depth == 0 || profile.depth > NUM_BUTTON_STATES)
+    {
+        return BUTTON_PROFILE_INVALID;
+    }
+
+    // Banks only have a handful of profiles, so a search is quick enough
+    for(i = 0; i < numProfiles; i++)
+    {
+        if(profiles[i].pullType == profile.pullType &&
+           profiles[i].depth == profile.depth &&
+           profiles[i].enabledPins == profile.enabledPins)
+        {
+            return (uint16_t)i;
+        }
+    }
+
+    if(numProfiles >= maxProfiles || numProfiles >= BUTTON_PROFILE_INVALID)
+    {
+        return BUTTON_PROFILE_INVALID;
+    }
+
+    profiles[numProfiles] = profile;
+
+    return (uint16_t)numProfiles++;
+}
+
+bool ProfiledDebouncerBank::
+SetProfile(uint32_t port, uint16_t profile)
+{
+    uint8_t j;
+
+    if(port >= numPorts || profile >= numProfiles)
+    {
+        return false;
+    }
+
+    // The history holds samples XORed with the old pullups, which would
+    // read as presses or releases under the new ones
+    if(profiles[profile].pullType != profiles[profileOf[port]].pullType)
+    {
+        for(j = 0; j < NUM_BUTTON_STATES; j++)
+        {
+            state[(size_t)numPorts * j + port] = 0;
+        }
+        debouncedState[port] = 0;
+        changed[port] = 0;
+    }
+
+    profileOf[port] = profile;
+
+    return true;
+}
+
+uint16_t ProfiledDebouncerBank::
+ProfileOf(uint32_t port) const
+{
+    return profileOf[port];
+}
+
+const DebouncerProfile &ProfiledDebouncerBank::
+Profile(uint16_t profile) const
+{
+    return profiles[profile];
+}
+
+void ProfiledDebouncerBank::
+ButtonProcess(const uint8_t *portStatus)
+{
+    const uint8_t *rows[NUM_BUTTON_STATES];
+    uint32_t port;
+    uint32_t runEnd;
+    uint16_t profile;
+    uint8_t j;
+
+    // The newest sample goes into state array index. rows[j] is the sample
+    // from j ticks ago, so the last depth samples are always rows[0] to
+    // rows[depth - 1].
+    for(j = 0; j < NUM_BUTTON_STATES; j++)
+    {
+        rows[j] = state + (size_t)numPorts *
+                  ((index + NUM_BUTTON_STATES - j) % NUM_BUTTON_STATES);
+    }
+
+    for(port = 0; port < numPorts; port = runEnd)
+    {
+        profile = profileOf[port];
+        runEnd = port + 1;
+        while(runEnd < numPorts && profileOf[runEnd] == profile)
+        {
+            runEnd++;
+        }
+
+        ProcessRun(port, runEnd, profiles[profile], portStatus, rows);
+    }
+
+    // Check to make sure the index hasn't gone over the limit
+    index++;
+    if(index >= NUM_BUTTON_STATES)
+    {
+        index = 0;
+    }
+}
+
+void ProfiledDebouncerBank::
+ProcessRun(uint32_t firstPort, uint32_t lastPort, const DebouncerProfile &profile,
+           const uint8_t *portStatus, const uint8_t *const *rows)
+{
+    uint8_t debounced[BUTTON_PROFILE_BLOCK_PORTS];
+    uint8_t *newest = state + (size_t)numPorts * index;
+    const uint8_t pull = profile.pullType;
+    const uint8_t enabled = profile.enabledPins;
+    const uint8_t depth = profile.depth;
+    const uint8_t *row;
+    uint32_t port;
+    uint32_t count;
+    uint32_t i;
+    uint8_t j;
+
+    // The profile is held in locals for the whole run so that the loops
+    // below only read samples
+    for(port = firstPort; port < lastPort; port += count)
+    {
+        count = lastPort - port;
+        if(count > BUTTON_PROFILE_BLOCK_PORTS)
+        {
+            count = BUTTON_PROFILE_BLOCK_PORTS;
+        }
+
+        for(i = 0; i < count; i++)
+        {
+            newest[port + i] = portStatus[port + i] ^ pull;
+        }
+
+        for(i = 0; i < count; i++)
+        {
+            debounced[i] = enabled;
+        }
+        for(j = 0; j < depth; j++)
+        {
+            row = rows[j] + port;
+            for(i = 0; i < count; i++)
+            {
+                debounced[i] &= row[i];
+            }
+        }
+
+        for(i = 0; i < count; i++)
+        {
+            changed[port + i] = debounced[i] ^ debouncedState[port + i];
+            debouncedState[port + i] = debounced[i];
+        }
+    }
+}
+
+uint8_t ProfiledDebouncerBank::
+ButtonPressed(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    return (changed[port] & debouncedState[port]) & GPIOButtonPins;
+}
+
+uint8_t ProfiledDebouncerBank::
+ButtonReleased(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    return (changed[port] & (~debouncedState[port])) & GPIOButtonPins;
+}
+
+uint8_t ProfiledDebouncerBank::
+ButtonCurrent(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    return debouncedState[port] & GPIOButtonPins;
+}
+
+uint32_t ProfiledDebouncerBank::
+NumPorts() const
+{
+    return numPorts;
+}
+
+uint32_t ProfiledDebouncerBank::
+NumProfiles() const
+{
+    return numProfiles;
+}
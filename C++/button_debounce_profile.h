@@ -0,0 +1,225 @@
+//*********************************************************************************
+// State Button Debouncer - Profiled Bank
+// 
+// Revision: 1.0
+// 
+// Description: A bank whose ports are configured through shared profiles
+// instead of settings stored with every port. A profile holds the pullups of
+// a port, the number of samples that must agree before a press is accepted
+// and the pins that are in use. Each port only stores the 16 bit number of
+// its profile, and adding a profile that already exists gives back the
+// existing one, so a few profiles can describe millions of ports.
+// 
+// ButtonProcess works through the ports in runs of neighbouring ports that
+// share a profile, loading the profile once per run. Giving neighbouring
+// ports the same profile keeps the runs long.
+// 
+// Requires C++11.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_PROFILE_H
+#define BUTTON_DEBOUNCER_PROFILE_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include "button_debounce.h"
+#include "button_debounce_arena.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// Returned by AddProfile when a profile can't be added
+#define BUTTON_PROFILE_INVALID      0xFFFF
+
+// 
+// The configuration shared by the ports of a profile
+// 
+struct
+DebouncerProfile
+{
+    // The pullups used on the port. See the Debouncer constructor.
+    uint8_t pullType;
+
+    // The number of samples in a row a pin must be pressed in to be
+    // debounced as pressed. From 1 to NUM_BUTTON_STATES.
+    uint8_t depth;
+
+    // The pins in use. Other pins are never debounced as pressed.
+    uint8_t enabledPins;
+};
+
+//*********************************************************************************
+// Class
+//*********************************************************************************
+
+class
+ProfiledDebouncerBank
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Initializes a bank of released ports that all use
+        //      defaultProfile, which becomes profile 0.
+        // Parameters:
+        //      numPorts - The number of ports in the bank.
+        //      maxProfiles - The most profiles the bank can hold, from 1 to
+        //          BUTTON_PROFILE_INVALID.
+        //      defaultProfile - The profile every port starts out with. A depth
+        //          of 0 or above NUM_BUTTON_STATES is replaced with
+        //          NUM_BUTTON_STATES.
+        //      arena - Where to allocate the bank from, or NULL for the
+        //          heap.
+        // Returns:
+        //      None
+        // 
+        ProfiledDebouncerBank(uint32_t numPorts, uint32_t maxProfiles,
+                              const DebouncerProfile &defaultProfile,
+                              DebouncerArena *arena = NULL);
+        ~ProfiledDebouncerBank();
+
+        // 
+        // Add Profile
+        // Description:
+        //      Gets the number of a profile, adding it if the bank doesn't
+        //      hold an identical one yet.
+        // Parameters:
+        //      profile - The profile.
+        // Returns:
+        //      The profile's number, or BUTTON_PROFILE_INVALID if the
+        //      profile's depth is out of range or the bank already holds
+        //      maxProfiles profiles.
+        // 
+        uint16_t AddProfile(const DebouncerProfile &profile);
+
+        // 
+        // Set Profile
+        // Description:
+        //      Changes the profile used by one port. The port keeps its
+        //      sample history and debounced state unless the new profile has
+        //      a different pull type. Its history was stored with the old
+        //      pullups, so the port is then reset as if it had just been
+        //      constructed.
+        // Parameters:
+        //      port - The port's index in the bank.
+        //      profile - A number returned by AddProfile.
+        // Returns:
+        //      False if the port or the profile is out of range, in which
+        //      case nothing changes. True otherwise.
+        // 
+        bool SetProfile(uint32_t port, uint16_t profile);
+
+        // 
+        // Profile Of and Profile
+        // Description:
+        //      Get the number of the profile a port uses and the settings of
+        //      a profile.
+        // 
+        uint16_t ProfileOf(uint32_t port) const;
+        const DebouncerProfile &Profile(uint16_t profile) const;
+
+        // 
+        // Button Process
+        // Description:
+        //      Debounces every port of the bank.
+        // Parameters:
+        //      portStatus - One status byte per port.
+        // Returns:
+        //      None
+        // 
+        void ButtonProcess(const uint8_t *portStatus);
+
+        // 
+        // Button Pressed, Button Released and Button Current
+        // Description:
+        //      Same as the Debouncer functions of the same name for one port.
+        // Parameters:
+        //      port - The port's index in the bank.
+        //      GPIOButtonPins - The ORed combination of BUTTON_PIN_*.
+        // 
+        uint8_t ButtonPressed(uint32_t port, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonReleased(uint32_t port, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonCurrent(uint32_t port, uint8_t GPIOButtonPins) const;
+
+        // 
+        // Num Ports and Num Profiles
+        // Description:
+        //      Get the number of ports and the number of different profiles
+        //      in the bank.
+        // 
+        uint32_t NumPorts() const;
+        uint32_t NumProfiles() const;
+
+    private:
+        ProfiledDebouncerBank(const ProfiledDebouncerBank &);
+        ProfiledDebouncerBank &operator=(const ProfiledDebouncerBank &);
+
+        // 
+        // Debounces the ports from firstPort up to but not including
+        // lastPort, which all use profile
+        // 
+        void ProcessRun(uint32_t firstPort, uint32_t lastPort,
+                        const DebouncerProfile &profile, const uint8_t *portStatus,
+                        const uint8_t *const *rows);
+
+        uint32_t numPorts;
+        DebouncerArena *arena;
+
+        // 
+        // Keeps up with which state array gets the next port statuses
+        // 
+        uint8_t index;
+
+        // 
+        // NUM_BUTTON_STATES arrays of numPorts samples, with the pulled up
+        // pins flipped so that a 1 bit always means pressed
+        // 
+        uint8_t *state;
+
+        // 
+        // The debounced state, changed pins and profile of each port
+        // 
+        uint8_t *debouncedState;
+        uint8_t *changed;
+        uint16_t *profileOf;
+
+        // 
+        // The profiles, without duplicates
+        // 
+        DebouncerProfile *profiles;
+        uint32_t numProfiles;
+        uint32_t maxProfiles;
+};
+
+#endif  // BUTTON_DEBOUNCER_PROFILE_H
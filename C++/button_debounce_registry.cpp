@@ -0,0 +1,265 @@
+//*********************************************************************************
+// State Button Debouncer - Port Registry
+// 
+// Revision: 1.0
+// 
+// Description: Hands out ports of a DebouncerBank to devices that come and
+// go. See button_debounce_registry.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include "button_debounce_registry.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// Ends the free list of handle table entries
+#define BUTTON_REGISTRY_END         0xFFFFFFFF
+
+//*********************************************************************************
+// Local Functions
+//*********************************************************************************
+
+static uint32_t
+HandleIndex(DebouncerHandle handle)
+{
+    return handle & (BUTTON_REGISTRY_MAX_PORTS - 1);
+}
+
+static uint8_t
+HandleGeneration(DebouncerHandle handle)
+{
+    return (uint8_t)(handle >> BUTTON_REGISTRY_INDEX_BITS);
+}
+
+//*********************************************************************************
+// Class Functions
+//*********************************************************************************
+DebouncerRegistry::
+DebouncerRegistry(uint32_t maxPorts, DebouncerArena *arena) :
+    arena(arena),
+    bank(maxPorts, 0x00, arena, BUTTON_BANK_SHARED_PULL)
+{
+    uint32_t i;
+
+    this->maxPorts = maxPorts;
+    numPorts = 0;
+
+    entries = DebouncerAllocate<Entry>(arena, maxPorts);
+    portToEntry = DebouncerAllocate<uint32_t>(arena, maxPorts);
+
+    // Chain every entry into the free list
+    for(i = 0; i < maxPorts; i++)
+    {
+        entries[i].port = i + 1 < maxPorts ? i + 1 : BUTTON_REGISTRY_END;
+        entries[i].generation = 0;
+        entries[i].used = false;
+    }
+    firstFree = maxPorts > 0 ? 0 : BUTTON_REGISTRY_END;
+}
+
+DebouncerRegistry::
+~DebouncerRegistry()
+{
+    DebouncerFree(arena, entries, maxPorts);
+    DebouncerFree(arena, portToEntry, maxPorts);
+}
+
+DebouncerHandle DebouncerRegistry::
+Add(uint8_t pulledUpButtons)
+{
+    uint32_t entry = firstFree;
+
+    if(entry == BUTTON_REGISTRY_END)
+    {
+        return BUTTON_REGISTRY_INVALID;
+    }
+
+    firstFree = entries[entry].port;
+
+    // The new device goes right after the ports in use
+    entries[entry].port = numPorts;
+    entries[entry].used = true;
+    portToEntry[numPorts] = entry;
+    bank.ResetPort(numPorts, pulledUpButtons);
+    numPorts++;
+
+    return ((DebouncerHandle)entries[entry].generation << BUTTON_REGISTRY_INDEX_BITS) | entry;
+}
+
+bool DebouncerRegistry::
+Remove(DebouncerHandle handle)
+{
+    uint32_t entry = HandleIndex(handle);
+    uint32_t port;
+    uint32_t last;
+
+    if(!Valid(handle))
+    {
+        return false;
+    }
+
+    // Fill the hole with the last port in use
+    port = entries[entry].port;
+    last = numPorts - 1;
+    if(port != last)
+    {
+        bank.MovePort(last, port);
+        portToEntry[port] = portToEntry[last];
+        entries[portToEntry[port]].port = port;
+    }
+    bank.ResetPort(last, 0x00);
+    numPorts--;
+
+    entries[entry].generation++;
+    entries[entry].used = false;
+    entries[entry].port = firstFree;
+    firstFree = entry;
+
+    return true;
+}
+
+uint32_t DebouncerRegistry::
+AddBatch(const uint8_t *pullTypes, uint32_t count, DebouncerHandle *handles)
+{
+    uint32_t i;
+
+    for(i = 0; i < count; i++)
+    {
+        handles[i] = Add(pullTypes[i]);
+        if(handles[i] == BUTTON_REGISTRY_INVALID)
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
+uint32_t DebouncerRegistry::
+RemoveBatch(const DebouncerHandle *handles, uint32_t count)
+{
+    uint32_t removed = 0;
+    uint32_t i;
+
+    for(i = 0; i < count; i++)
+    {
+        if(Remove(handles[i]))
+        {
+            removed++;
+        }
+    }
+
+    return removed;
+}
+
+bool DebouncerRegistry::
+Valid(DebouncerHandle handle) const
+{
+    uint32_t entry = HandleIndex(handle);
+
+    return handle != BUTTON_REGISTRY_INVALID && entry < maxPorts &&
+           entries[entry].used &&
+           entries[entry].generation == HandleGeneration(handle);
+}
+
+uint32_t DebouncerRegistry::
+PortOf(DebouncerHandle handle) const
+{
+    return entries[HandleIndex(handle)].port;
+}
+
+DebouncerHandle DebouncerRegistry::
+HandleOf(uint32_t port) const
+{
+    uint32_t entry = portToEntry[port];
+
+    return ((DebouncerHandle)entries[entry].generation << BUTTON_REGISTRY_INDEX_BITS) | entry;
+}
+
+void DebouncerRegistry::
+ButtonProcess(const uint8_t *portStatus)
+{
+    // Only the packed ports in use are debounced
+    bank.ButtonProcessRange(0, numPorts, portStatus);
+    bank.AdvanceIndex();
+}
+
+uint8_t DebouncerRegistry::
+ButtonPressed(DebouncerHandle handle, uint8_t GPIOButtonPins) const
+{
+    if(!Valid(handle))
+    {
+        return 0;
+    }
+
+    return bank.ButtonPressed(PortOf(handle), GPIOButtonPins);
+}
+
+uint8_t DebouncerRegistry::
+ButtonReleased(DebouncerHandle handle, uint8_t GPIOButtonPins) const
+{
+    if(!Valid(handle))
+    {
+        return 0;
+    }
+
+    return bank.ButtonReleased(PortOf(handle), GPIOButtonPins);
+}
+
+uint8_t DebouncerRegistry::
+ButtonCurrent(DebouncerHandle handle, uint8_t GPIOButtonPins) const
+{
+    if(!Valid(handle))
+    {
+        return 0;
+    }
+
+    return bank.ButtonCurrent(PortOf(handle), GPIOButtonPins);
+}
+
+uint32_t DebouncerRegistry::
+NumPorts() const
+{
+    return numPorts;
+}
+
+uint32_t DebouncerRegistry::
+MaxPorts() const
+{
+    return maxPorts;
+}
+
+const DebouncerBank &DebouncerRegistry::
+Bank() const
+{
+    return bank;
+}
@@ -0,0 +1,231 @@
+//*********************************************************************************
+// State Button Debouncer - Port Registry
+// 
+// Revision: 1.0
+// 
+// Description: Hands out ports of a DebouncerBank to devices that come and
+// go, such as hot plugged ones. A device is added with Add and gets a handle
+// that stays valid until the device is removed, even though the port behind
+// it may move. The ports in use are always kept packed at the start of the
+// bank, so ButtonProcess only debounces the ports in use and does so with
+// the bank's vectorized loop.
+// 
+// A handle holds the index of an entry in the registry's handle table and
+// the generation of that entry. Removing a device bumps the generation so that
+// the old handle stops working when the entry is reused. Generations wrap
+// after 256 reuses of the same entry.
+// 
+// Devices should be added and removed between ticks.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_REGISTRY_H
+#define BUTTON_DEBOUNCER_REGISTRY_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include "button_debounce_bank.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// The number of bits of a handle that hold the handle table index. The rest
+// hold the generation.
+#define BUTTON_REGISTRY_INDEX_BITS  24
+
+// The most ports a registry can hold
+#define BUTTON_REGISTRY_MAX_PORTS   (1u << BUTTON_REGISTRY_INDEX_BITS)
+
+// Never handed out as a handle
+#define BUTTON_REGISTRY_INVALID     0xFFFFFFFF
+
+typedef uint32_t DebouncerHandle;
+
+//*********************************************************************************
+// Class
+//*********************************************************************************
+
+class
+DebouncerRegistry
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Initializes an empty registry.
+        // Parameters:
+        //      maxPorts - The most devices that can be registered at once.
+        //          At most BUTTON_REGISTRY_MAX_PORTS - 1.
+        //      arena - Where to allocate the registry and its bank from, or
+        //          NULL for the heap.
+        // Returns:
+        //      None
+        // 
+        DebouncerRegistry(uint32_t maxPorts, DebouncerArena *arena = NULL);
+        ~DebouncerRegistry();
+
+        // 
+        // Add
+        // Description:
+        //      Registers a device. Its port starts out like a newly
+        //      constructed Debouncer.
+        // Parameters:
+        //      pulledUpButtons - See the Debouncer constructor.
+        // Returns:
+        //      The device's handle, or BUTTON_REGISTRY_INVALID if the registry
+        //      is full.
+        // 
+        DebouncerHandle Add(uint8_t pulledUpButtons);
+
+        // 
+        // Remove
+        // Description:
+        //      Unregisters a device. The last port in use is moved into the
+        //      device's port to keep the ports in use packed.
+        // Parameters:
+        //      handle - The device's handle.
+        // Returns:
+        //      False if the handle is no longer valid.
+        // 
+        bool Remove(DebouncerHandle handle);
+
+        // 
+        // Add Batch
+        // Description:
+        //      Registers several devices.
+        // Parameters:
+        //      pullTypes - The pulledUpButtons of every device.
+        //      count - The number of devices.
+        //      handles - Filled in with the handles of the devices.
+        // Returns:
+        //      The number of devices registered, which is less than count
+        //      if the registry filled up.
+        // 
+        uint32_t AddBatch(const uint8_t *pullTypes, uint32_t count,
+                          DebouncerHandle *handles);
+
+        // 
+        // Remove Batch
+        // Description:
+        //      Unregisters several devices.
+        // Parameters:
+        //      handles - The handles of the devices.
+        //      count - The number of handles.
+        // Returns:
+        //      The number of handles that were valid and removed.
+        // 
+        uint32_t RemoveBatch(const DebouncerHandle *handles, uint32_t count);
+
+        // 
+        // Valid
+        // Description:
+        //      Checks whether a handle belongs to a registered device.
+        // 
+        bool Valid(DebouncerHandle handle) const;
+
+        // 
+        // Port Of and Handle Of
+        // Description:
+        //      Translate between a device's handle and the bank port that
+        //      currently holds it. The port of a device changes when another
+        //      device is removed.
+        // 
+        uint32_t PortOf(DebouncerHandle handle) const;
+        DebouncerHandle HandleOf(uint32_t port) const;
+
+        // 
+        // Button Process
+        // Description:
+        //      Debounces every registered device.
+        // Parameters:
+        //      portStatus - One status byte per port in use, NumPorts() in
+        //          all, indexed by port.
+        // Returns:
+        //      None
+        // 
+        void ButtonProcess(const uint8_t *portStatus);
+
+        // 
+        // Button Pressed, Button Released and Button Current
+        // Description:
+        //      Same as the Debouncer functions of the same name for one
+        //      device. Return 0 for handles that are no longer valid.
+        // 
+        uint8_t ButtonPressed(DebouncerHandle handle, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonReleased(DebouncerHandle handle, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonCurrent(DebouncerHandle handle, uint8_t GPIOButtonPins) const;
+
+        // 
+        // Num Ports and Max Ports
+        // Description:
+        //      Get the number of registered devices and the most there can
+        //      be.
+        // 
+        uint32_t NumPorts() const;
+        uint32_t MaxPorts() const;
+
+        // 
+        // Bank
+        // Description:
+        //      Gets the bank. Only its first NumPorts() ports are in use.
+        // 
+        const DebouncerBank &Bank() const;
+
+    private:
+        DebouncerRegistry(const DebouncerRegistry &);
+        DebouncerRegistry &operator=(const DebouncerRegistry &);
+
+        // 
+        // An entry of the handle table. Holds the port of a registered
+        // device or the next free entry.
+        // 
+        struct
+        Entry
+        {
+            uint32_t port;
+            uint8_t generation;
+            bool used;
+        };
+
+        DebouncerArena *arena;
+        DebouncerBank bank;
+
+        Entry *entries;
+        uint32_t *portToEntry;
+        uint32_t firstFree;
+
+        uint32_t numPorts;
+        uint32_t maxPorts;
+};
+
+#endif  // BUTTON_DEBOUNCER_REGISTRY_H
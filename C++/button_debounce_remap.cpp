@@ -0,0 +1,299 @@
+//*********************************************************************************
+// State Button Debouncer - Pin Remapping
+// 
+// Revision: 1.0
+// 
+// Description: Puts the pins of every port into logical order. See
+// button_debounce_remap.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <string.h>
+#if defined(__GFNI__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+#include "button_debounce_remap.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// The number of ports sharing one GFNI matrix
+#define BUTTON_REMAP_GROUP_PORTS    8
+
+// The number of ports remapped together by the vector paths
+#define BUTTON_REMAP_BLOCK_PORTS    16
+
+//*********************************************************************************
+// Class Functions
+//*********************************************************************************
+DebouncerPinRemap::
+DebouncerPinRemap(uint32_t numPorts, uint32_t maxMappings, DebouncerArena *arena)
+{
+    static const uint8_t identity[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    uint32_t i;
+
+    this->numPorts = numPorts;
+    this->maxMappings = maxMappings;
+    this->arena = arena;
+    numGroups = (numPorts + (BUTTON_REMAP_GROUP_PORTS - 1)) / BUTTON_REMAP_GROUP_PORTS;
+
+    physical = DebouncerAllocate<uint8_t>(arena, (size_t)maxMappings * 8);
+    inverted = DebouncerAllocate<uint8_t>(arena, maxMappings);
+    table = DebouncerAllocate<uint8_t>(arena, (size_t)maxMappings * 256);
+    matrix = DebouncerAllocate<uint64_t>(arena, maxMappings);
+    nibbles = DebouncerAllocate<uint8_t>(arena, (size_t)maxMappings * 32);
+    mappingOf = DebouncerAllocate<uint16_t>(arena, numPorts);
+    groupMapping = DebouncerAllocate<uint16_t>(arena, numGroups);
+    logical = DebouncerAllocate<uint8_t>(arena, numPorts);
+
+    memcpy(physical, identity, 8);
+    inverted[0] = 0;
+    Compile(0);
+    numMappings = 1;
+
+    memset(mappingOf, 0x00, sizeof(uint16_t) * numPorts);
+    for(i = 0; i < numGroups; i++)
+    {
+        groupMapping[i] = 0;
+    }
+}
+
+DebouncerPinRemap::
+~DebouncerPinRemap()
+{
+    DebouncerFree(arena, physical, (size_t)maxMappings * 8);
+    DebouncerFree(arena, inverted, maxMappings);
+    DebouncerFree(arena, table, (size_t)maxMappings * 256);
+    DebouncerFree(arena, matrix, maxMappings);
+    DebouncerFree(arena, nibbles, (size_t)maxMappings * 32);
+    DebouncerFree(arena, mappingOf, numPorts);
+    DebouncerFree(arena, groupMapping, numGroups);
+    DebouncerFree(arena, logical, numPorts);
+}
+
+void DebouncerPinRemap::
+Compile(uint16_t mapping)
+{
+    const uint8_t *pins = physical + (size_t)mapping * 8;
+    uint8_t *entries = table + (size_t)mapping * 256;
+    uint8_t *low = nibbles + (size_t)mapping * 32;
+    uint8_t *high = low + 16;
+    uint8_t logicalPins;
+    uint32_t x;
+    uint8_t i;
+
+    for(x = 0; x < 256; x++)
+    {
+        logicalPins = 0;
+        for(i = 0; i < 8; i++)
+        {
+            logicalPins |= (uint8_t)(((x >> pins[i]) & 1) << i);
+        }
+        entries[x] = logicalPins;
+    }
+
+    // Moving pins never mixes them, so the two nibbles of a status byte
+    // can be looked up apart and ORed back together
+    for(x = 0; x < 16; x++)
+    {
+        low[x] = entries[x];
+        high[x] = entries[x << 4];
+    }
+
+    // Row 7 - i of the matrix picks the bit that becomes bit i
+    matrix[mapping] = 0;
+    for(i = 0; i < 8; i++)
+    {
+        matrix[mapping] |= (uint64_t)(1 << pins[i]) << (8 * (7 - i));
+    }
+}
+
+uint16_t DebouncerPinRemap::
+AddMapping(const uint8_t *physicalPins, uint8_t invertedPins)
+{
+    uint8_t used = 0;
+    uint32_t i;
+
+    for(i = 0; i < 8; i++)
+    {
+        if(physicalPins[i] > 7)
+        {
+            return BUTTON_REMAP_INVALID;
+        }
+        used |= (uint8_t)(1 << physicalPins[i]);
+    }
+
+    if(used != 0xFF)
+    {
+        return BUTTON_REMAP_INVALID;
+    }
+
+    // There are only ever a few different wirings, so a search is quick
+    // enough
+    for(i = 0; i < numMappings; i++)
+    {
+        if(inverted[i] == invertedPins && memcmp(physical + i * 8, physicalPins, 8) == 0)
+        {
+            return (uint16_t)i;
+        }
+    }
+
+    if(numMappings >= maxMappings || numMappings >= BUTTON_REMAP_INVALID)
+    {
+        return BUTTON_REMAP_INVALID;
+    }
+
+    memcpy(physical + (size_t)numMappings * 8, physicalPins, 8);
+    inverted[numMappings] = invertedPins;
+    Compile((uint16_t)numMappings);
+
+    return (uint16_t)numMappings++;
+}
+
+void DebouncerPinRemap::
+SetMapping(uint32_t port, uint16_t mapping)
+{
+    uint32_t group = port / BUTTON_REMAP_GROUP_PORTS;
+    uint32_t first = group * BUTTON_REMAP_GROUP_PORTS;
+    uint32_t i;
+
+    mappingOf[port] = mapping;
+
+    // Work out again whether the port's group still shares one mapping
+    groupMapping[group] = mapping;
+    for(i = first; i < first + BUTTON_REMAP_GROUP_PORTS && i < numPorts; i++)
+    {
+        if(mappingOf[i] != mapping)
+        {
+            groupMapping[group] = BUTTON_REMAP_INVALID;
+            break;
+        }
+    }
+}
+
+uint8_t DebouncerPinRemap::
+PullType(uint32_t port) const
+{
+    return inverted[mappingOf[port]];
+}
+
+void DebouncerPinRemap::
+ApplyPullTypes(DebouncerBank &bank) const
+{
+    uint32_t port;
+
+    for(port = 0; port < numPorts; port++)
+    {
+        bank.SetPullType(port, inverted[mappingOf[port]]);
+    }
+}
+
+const uint8_t *DebouncerPinRemap::
+Remap(const uint8_t *portStatus)
+{
+    uint32_t port = 0;
+    uint32_t i;
+#if defined(__GFNI__) || defined(__SSSE3__)
+    uint32_t group;
+    __m128i status;
+#endif
+#if !defined(__GFNI__) && defined(__SSSE3__)
+    const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+    const uint8_t *low;
+#endif
+
+    for(; port + BUTTON_REMAP_BLOCK_PORTS <= numPorts; port += BUTTON_REMAP_BLOCK_PORTS)
+    {
+#if defined(__GFNI__) || defined(__SSSE3__)
+        group = port / BUTTON_REMAP_GROUP_PORTS;
+#endif
+
+#if defined(__GFNI__)
+        // Each 64 bit lane gets the matrix of its own group of 8 ports
+        if(groupMapping[group] != BUTTON_REMAP_INVALID &&
+           groupMapping[group + 1] != BUTTON_REMAP_INVALID)
+        {
+            status = _mm_loadu_si128((const __m128i *)(portStatus + port));
+            status = _mm_gf2p8affine_epi64_epi8(status,
+                                                _mm_set_epi64x((long long)matrix[groupMapping[group + 1]],
+                                                               (long long)matrix[groupMapping[group]]),
+                                                0);
+            _mm_storeu_si128((__m128i *)(logical + port), status);
+            continue;
+        }
+#elif defined(__SSSE3__)
+        // The nibble tables are shared by all 16 ports
+        if(groupMapping[group] != BUTTON_REMAP_INVALID &&
+           groupMapping[group] == groupMapping[group + 1])
+        {
+            low = nibbles + (size_t)groupMapping[group] * 32;
+            status = _mm_loadu_si128((const __m128i *)(portStatus + port));
+            status = _mm_or_si128(
+                _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)low),
+                                 _mm_and_si128(status, nibbleMask)),
+                _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(low + 16)),
+                                 _mm_and_si128(_mm_srli_epi16(status, 4), nibbleMask)));
+            _mm_storeu_si128((__m128i *)(logical + port), status);
+            continue;
+        }
+#endif
+
+        for(i = port; i < port + BUTTON_REMAP_BLOCK_PORTS; i++)
+        {
+            logical[i] = table[(size_t)mappingOf[i] * 256 + portStatus[i]];
+        }
+    }
+
+    for(; port < numPorts; port++)
+    {
+        logical[port] = table[(size_t)mappingOf[port] * 256 + portStatus[port]];
+    }
+
+    return logical;
+}
+
+void DebouncerPinRemap::
+ButtonProcess(const uint8_t *portStatus, DebouncerBank &bank)
+{
+    bank.ButtonProcess(Remap(portStatus));
+}
+
+uint32_t DebouncerPinRemap::
+NumPorts() const
+{
+    return numPorts;
+}
+
+uint32_t DebouncerPinRemap::
+NumMappings() const
+{
+    return numMappings;
+}
@@ -0,0 +1,205 @@
+//*********************************************************************************
+// State Button Debouncer - Pin Remapping
+// 
+// Revision: 1.0
+// 
+// Description: Puts the pins of every port into logical order before the
+// ports are debounced, for boards whose wiring doesn't match the order the
+// buttons should be numbered in. Each port refers to a mapping that says
+// which physical pin feeds each logical pin. Identical mappings are only
+// stored once.
+// 
+// Every mapping is turned into tables when it is added, so remapping a port
+// never loops over its bits. Processors with GFNI remap 16 ports at a time
+// with one affine transform, as long as each group of 8 ports shares a
+// mapping. With SSSE3, 16 ports sharing a mapping are remapped with two
+// nibble shuffles. Everything else goes through a 256 entry table per
+// mapping.
+// 
+// Mappings also say which logical pins read 1 when released. Rather than
+// flipping them on every tick, ApplyPullTypes hands them to a bank as pull
+// types, which the bank flips anyway.
+// 
+// Requires C++11.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_REMAP_H
+#define BUTTON_DEBOUNCER_REMAP_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include "button_debounce_arena.h"
+#include "button_debounce_bank.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// Returned by AddMapping when a mapping can't be added
+#define BUTTON_REMAP_INVALID        0xFFFF
+
+//*********************************************************************************
+// Class
+//*********************************************************************************
+
+class
+DebouncerPinRemap
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Initializes every port with mapping 0, which leaves the pins
+        //      where they are and has no inverted pins.
+        // Parameters:
+        //      numPorts - The number of ports.
+        //      maxMappings - The most mappings that can be held, counting
+        //          mapping 0, from 1 to BUTTON_REMAP_INVALID.
+        //      arena - Where to allocate the tables from, or NULL for the
+        //          heap.
+        // Returns:
+        //      None
+        // 
+        DebouncerPinRemap(uint32_t numPorts, uint32_t maxMappings,
+                          DebouncerArena *arena = NULL);
+        ~DebouncerPinRemap();
+
+        // 
+        // Add Mapping
+        // Description:
+        //      Gets the number of a mapping, adding it if there isn't an
+        //      identical one yet.
+        // Parameters:
+        //      physicalPins - physicalPins[i] is the physical pin, 0 to 7,
+        //          wired to logical pin i. Every physical pin must be used
+        //          once.
+        //      invertedPins - The logical pins that read 1 when released.
+        // Returns:
+        //      The mapping's number, or BUTTON_REMAP_INVALID if physicalPins
+        //      isn't a permutation or maxMappings mappings are held already.
+        // 
+        uint16_t AddMapping(const uint8_t *physicalPins, uint8_t invertedPins);
+
+        // 
+        // Set Mapping
+        // Description:
+        //      Changes the mapping used by one port.
+        // Parameters:
+        //      port - The port.
+        //      mapping - A number returned by AddMapping.
+        // Returns:
+        //      None
+        // 
+        void SetMapping(uint32_t port, uint16_t mapping);
+
+        // 
+        // Pull Type and Apply Pull Types
+        // Description:
+        //      Get the pull type a port needs in logical pin order, and set
+        //      the pull type of every port of a bank with numPorts ports.
+        // 
+        uint8_t PullType(uint32_t port) const;
+        void ApplyPullTypes(DebouncerBank &bank) const;
+
+        // 
+        // Remap
+        // Description:
+        //      Puts the pins of every port into logical order.
+        // Parameters:
+        //      portStatus - One physical status byte per port.
+        // Returns:
+        //      The logical port statuses. Valid until the next call.
+        // 
+        const uint8_t *Remap(const uint8_t *portStatus);
+
+        // 
+        // Button Process
+        // Description:
+        //      Remaps the ports and debounces them with a bank whose pull
+        //      types were set by ApplyPullTypes.
+        // Parameters:
+        //      portStatus - One physical status byte per port.
+        //      bank - The bank.
+        // Returns:
+        //      None
+        // 
+        void ButtonProcess(const uint8_t *portStatus, DebouncerBank &bank);
+
+        // 
+        // Num Ports and Num Mappings
+        // Description:
+        //      Get the number of ports and the number of different mappings.
+        // 
+        uint32_t NumPorts() const;
+        uint32_t NumMappings() const;
+
+    private:
+        DebouncerPinRemap(const DebouncerPinRemap &);
+        DebouncerPinRemap &operator=(const DebouncerPinRemap &);
+
+        // 
+        // Builds the tables of a mapping
+        // 
+        void Compile(uint16_t mapping);
+
+        uint32_t numPorts;
+        uint32_t numGroups;
+        uint32_t numMappings;
+        uint32_t maxMappings;
+        DebouncerArena *arena;
+
+        // 
+        // Each mapping's physical pins and inverted pins, a 256 entry
+        // table, the 8 x 8 bit matrix used by GFNI and the tables of the
+        // low and high nibbles used by SSSE3
+        // 
+        uint8_t *physical;
+        uint8_t *inverted;
+        uint8_t *table;
+        uint64_t *matrix;
+        uint8_t *nibbles;
+
+        // 
+        // The mapping of each port, and of each group of 8 ports or
+        // BUTTON_REMAP_INVALID if the group's ports use different ones
+        // 
+        uint16_t *mappingOf;
+        uint16_t *groupMapping;
+
+        // 
+        // The logical port statuses
+        // 
+        uint8_t *logical;
+};
+
+#endif  // BUTTON_DEBOUNCER_REMAP_H
@@ -0,0 +1,143 @@
+//*********************************************************************************
+// State Button Debouncer - Sequence Lock
+// 
+// Revision: 1.0
+// 
+// Description: A sequence lock lets one writer update debouncer state while
+// any number of readers query it without ever blocking the writer. The writer
+// makes the sequence number odd while it is updating and even again when it
+// is done. A reader remembers the sequence number before reading and reads
+// again if the number was odd or has moved on in the meantime.
+// 
+// The lock only holds a single lock free atomic word so it can also be placed
+// in memory that is shared between processes. Requires C++11.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_SEQLOCK_H
+#define BUTTON_DEBOUNCER_SEQLOCK_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include <atomic>
+
+//*********************************************************************************
+// Class
+//*********************************************************************************
+
+class
+DebouncerSeqLock
+{
+    public:
+        // 
+        // Initialize
+        // Description:
+        //      Puts the lock into its unlocked state. Needed when the lock
+        //      lives in memory that wasn't constructed, such as a freshly
+        //      mapped shared memory segment.
+        // 
+        void Init()
+        {
+            sequence.store(0, std::memory_order_relaxed);
+        }
+
+        // 
+        // Write Begin and Write End
+        // Description:
+        //      Surround every update of the protected state. Only one writer
+        //      may use the lock.
+        // 
+        void WriteBegin()
+        {
+            sequence.store(sequence.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        void WriteEnd()
+        {
+            sequence.store(sequence.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_release);
+        }
+
+        // 
+        // Read Begin
+        // Description:
+        //      Waits out a writer that is in the middle of an update.
+        // Returns:
+        //      The sequence number to pass to ReadRetry.
+        // 
+        uint32_t ReadBegin() const
+        {
+            uint32_t seq;
+
+            while((seq = sequence.load(std::memory_order_acquire)) & 1)
+            {
+#if defined(__x86_64__) || defined(__i386__)
+                __builtin_ia32_pause();
+#endif
+            }
+
+            return seq;
+        }
+
+        // 
+        // Read Retry
+        // Description:
+        //      Checks whether the state read since ReadBegin may have been
+        //      torn by the writer.
+        // Parameters:
+        //      seq - The value returned by ReadBegin.
+        // Returns:
+        //      True if the reads must be done again.
+        // 
+        bool ReadRetry(uint32_t seq) const
+        {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return sequence.load(std::memory_order_relaxed) != seq;
+        }
+
+        // 
+        // Updates
+        // Description:
+        //      Gets the number of updates completed so far.
+        // 
+        uint32_t Updates() const
+        {
+            return sequence.load(std::memory_order_acquire) >> 1;
+        }
+
+    private:
+        std::atomic<uint32_t> sequence;
+};
+
+#endif  // BUTTON_DEBOUNCER_SEQLOCK_H
@@ -0,0 +1,341 @@
+//*********************************************************************************
+// State Button Debouncer - Shared Memory Bank
+// 
+// Revision: 1.0
+// 
+// Description: Places a debouncer bank inside a POSIX shared memory segment.
+// See button_debounce_shm.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <new>
+#include "button_debounce_shm.h"
+
+//*********************************************************************************
+// Local Functions
+//*********************************************************************************
+
+// 
+// The bank storage follows the header on the next BUTTON_BANK_ALIGNMENT
+// boundary
+// 
+static size_t
+ShmHeaderSize()
+{
+    return (sizeof(DebouncerShmHeader) + (BUTTON_BANK_ALIGNMENT - 1)) &
+           ~(size_t)(BUTTON_BANK_ALIGNMENT - 1);
+}
+
+//*********************************************************************************
+// Writer Functions
+//*********************************************************************************
+SharedDebouncerBankWriter::
+SharedDebouncerBankWriter()
+{
+    header = NULL;
+    mappedSize = 0;
+    bank = NULL;
+}
+
+SharedDebouncerBankWriter::
+~SharedDebouncerBankWriter()
+{
+    Close();
+}
+
+bool SharedDebouncerBankWriter::
+Create(const char *name, uint32_t numPorts, uint8_t pulledUpButtons)
+{
+    size_t storageSize = DebouncerBank::StorageSize(numPorts);
+    size_t size = ShmHeaderSize() + storageSize;
+    void *mapping;
+    int error;
+    int fd;
+
+    Close();
+
+    // An earlier segment may still be mapped by readers, and shrinking it
+    // would leave them with a SIGBUS. Unlinking it lets them keep their
+    // mapping, and the new segment can't be opened by readers until its
+    // magic number is written below.
+    if(shm_unlink(name) != 0 && errno != ENOENT)
+    {
+        return false;
+    }
+
+    fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if(fd < 0)
+    {
+        return false;
+    }
+
+    // A segment this call created but couldn't set up is unlinked again,
+    // so that no empty or half sized segment is left behind. errno is kept
+    // from the call that failed.
+    if(ftruncate(fd, size) != 0)
+    {
+        error = errno;
+        close(fd);
+        shm_unlink(name);
+        errno = error;
+        return false;
+    }
+
+    mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    error = errno;
+    close(fd);
+    if(mapping == MAP_FAILED)
+    {
+        shm_unlink(name);
+        errno = error;
+        return false;
+    }
+
+    header = new(mapping) DebouncerShmHeader;
+    mappedSize = size;
+
+    header->version = BUTTON_SHM_VERSION;
+    header->headerSize = ShmHeaderSize();
+    header->numStates = NUM_BUTTON_STATES;
+    header->numPorts = numPorts;
+    header->storageSize = storageSize;
+    header->lock.Init();
+
+    // The segment was just created so it reads as zeros, and pages are
+    // only given to the segment as ports write to them
+    bank = new DebouncerBank(numPorts, pulledUpButtons,
+                             (uint8_t *)mapping + header->headerSize,
+                             BUTTON_BANK_SHARED_PULL | BUTTON_BANK_ZEROED_STORAGE);
+
+    // Publish the segment only once everything above is in place
+    __atomic_store_n(&header->magic, BUTTON_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+void SharedDebouncerBankWriter::
+Close()
+{
+    delete bank;
+    bank = NULL;
+
+    if(header != NULL)
+    {
+        munmap(header, mappedSize);
+        header = NULL;
+        mappedSize = 0;
+    }
+}
+
+bool SharedDebouncerBankWriter::
+Remove(const char *name)
+{
+    return shm_unlink(name) == 0;
+}
+
+void SharedDebouncerBankWriter::
+SetPullType(uint32_t port, uint8_t pulledUpButtons)
+{
+    header->lock.WriteBegin();
+    bank->SetPullType(port, pulledUpButtons);
+    header->lock.WriteEnd();
+}
+
+void SharedDebouncerBankWriter::
+ButtonProcess(const uint8_t *portStatus)
+{
+    header->lock.WriteBegin();
+    bank->ButtonProcess(portStatus);
+    header->lock.WriteEnd();
+}
+
+const DebouncerBank &SharedDebouncerBankWriter::
+Bank() const
+{
+    return *bank;
+}
+
+//*********************************************************************************
+// Reader Functions
+//*********************************************************************************
+SharedDebouncerBankReader::
+SharedDebouncerBankReader()
+{
+    header = NULL;
+    mappedSize = 0;
+    bank = NULL;
+}
+
+SharedDebouncerBankReader::
+~SharedDebouncerBankReader()
+{
+    Close();
+}
+
+bool SharedDebouncerBankReader::
+Open(const char *name)
+{
+    struct stat info;
+    void *mapping;
+    int fd;
+
+    Close();
+
+    fd = shm_open(name, O_RDONLY, 0);
+    if(fd < 0)
+    {
+        return false;
+    }
+
+    if(fstat(fd, &info) != 0 || (size_t)info.st_size < ShmHeaderSize())
+    {
+        close(fd);
+        return false;
+    }
+
+    mapping = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(mapping == MAP_FAILED)
+    {
+        return false;
+    }
+
+    header = (const DebouncerShmHeader *)mapping;
+    mappedSize = info.st_size;
+
+    // Make sure the segment has been published and was laid out the same
+    // way this reader would lay it out
+    if(__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != BUTTON_SHM_MAGIC ||
+       header->version != BUTTON_SHM_VERSION ||
+       header->headerSize != ShmHeaderSize() ||
+       header->numStates != NUM_BUTTON_STATES ||
+       header->storageSize != DebouncerBank::StorageSize(header->numPorts) ||
+       header->headerSize + header->storageSize > (uint64_t)mappedSize)
+    {
+        Close();
+        return false;
+    }
+
+    bank = new DebouncerBank((const uint8_t *)mapping + header->headerSize,
+                             header->numPorts);
+
+    return true;
+}
+
+void SharedDebouncerBankReader::
+Close()
+{
+    delete bank;
+    bank = NULL;
+
+    if(header != NULL)
+    {
+        munmap((void *)header, mappedSize);
+        header = NULL;
+        mappedSize = 0;
+    }
+}
+
+uint8_t SharedDebouncerBankReader::
+ButtonPressed(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    uint32_t seq;
+    uint8_t pins;
+
+    do
+    {
+        seq = header->lock.ReadBegin();
+        pins = bank->ButtonPressed(port, GPIOButtonPins);
+    }
+    while(header->lock.ReadRetry(seq));
+
+    return pins;
+}
+
+uint8_t SharedDebouncerBankReader::
+ButtonReleased(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    uint32_t seq;
+    uint8_t pins;
+
+    do
+    {
+        seq = header->lock.ReadBegin();
+        pins = bank->ButtonReleased(port, GPIOButtonPins);
+    }
+    while(header->lock.ReadRetry(seq));
+
+    return pins;
+}
+
+uint8_t SharedDebouncerBankReader::
+ButtonCurrent(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    uint32_t seq;
+    uint8_t pins;
+
+    do
+    {
+        seq = header->lock.ReadBegin();
+        pins = bank->ButtonCurrent(port, GPIOButtonPins);
+    }
+    while(header->lock.ReadRetry(seq));
+
+    return pins;
+}
+
+uint32_t SharedDebouncerBankReader::
+ReadBegin() const
+{
+    return header->lock.ReadBegin();
+}
+
+bool SharedDebouncerBankReader::
+ReadRetry(uint32_t seq) const
+{
+    return header->lock.ReadRetry(seq);
+}
+
+uint32_t SharedDebouncerBankReader::
+Ticks() const
+{
+    return header->lock.Updates();
+}
+
+const DebouncerBank &SharedDebouncerBankReader::
+Bank() const
+{
+    return *bank;
+}
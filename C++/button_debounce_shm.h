@@ -0,0 +1,241 @@
+//*********************************************************************************
+// State Button Debouncer - Shared Memory Bank
+// 
+// Revision: 1.0
+// 
+// Description: Places a debouncer bank inside a POSIX shared memory segment so
+// that several processes can query the same debounced buttons. One writer
+// process creates the segment and calls ButtonProcess. Any number of reader
+// processes open the segment read only and query it in place. Reading a
+// button does not copy the bank or make a system call; a sequence lock keeps
+// readers from seeing a half processed tick.
+// 
+// The segment starts with a header that records the layout of the bank so
+// that readers built with a different NUM_BUTTON_STATES or an older version
+// of this library refuse to open it.
+// 
+// Requires a POSIX system and C++11. Older C libraries need -lrt.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_SHM_H
+#define BUTTON_DEBOUNCER_SHM_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stddef.h>
+#include <stdint.h>
+#include "button_debounce_bank.h"
+#include "button_debounce_seqlock.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// Identifies a shared memory debouncer bank ("BDSH")
+#define BUTTON_SHM_MAGIC        0x48534442
+
+// Changes whenever the layout of the segment changes
+#define BUTTON_SHM_VERSION      3
+
+// 
+// The header at the start of every segment. The sequence lock is kept on a
+// cache line of its own so that readers polling it don't share a line with
+// anything the writer touches besides the lock itself.
+// 
+struct
+DebouncerShmHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t numStates;
+    uint32_t numPorts;
+    uint64_t storageSize;
+
+    alignas(BUTTON_BANK_ALIGNMENT) DebouncerSeqLock lock;
+};
+
+//*********************************************************************************
+// Classes
+//*********************************************************************************
+
+class
+SharedDebouncerBankWriter
+{
+    public:
+        SharedDebouncerBankWriter();
+        ~SharedDebouncerBankWriter();
+
+        // 
+        // Create
+        // Description:
+        //      Creates (or replaces) the named segment and formats a bank of
+        //      numPorts ports inside of it. A segment being replaced is
+        //      unlinked rather than cleared, so readers that still have it
+        //      mapped keep their old copy until they open the new one.
+        // Parameters:
+        //      name - The shm_open name of the segment, such as "/buttons".
+        //      numPorts - The number of ports in the bank.
+        //      pulledUpButtons - See the Debouncer constructor.
+        // Returns:
+        //      True on success. False if the segment couldn't be created or
+        //      mapped, in which case errno tells why.
+        // 
+        bool Create(const char *name, uint32_t numPorts, uint8_t pulledUpButtons);
+
+        // 
+        // Close
+        // Description:
+        //      Unmaps the segment. Readers that have it open keep working
+        //      with the last processed state. Called by the destructor.
+        // 
+        void Close();
+
+        // 
+        // Remove
+        // Description:
+        //      Removes the named segment from the system once every process
+        //      has closed it.
+        // Parameters:
+        //      name - The shm_open name of the segment.
+        // Returns:
+        //      True on success.
+        // 
+        static bool Remove(const char *name);
+
+        // 
+        // Set Pull Type and Button Process
+        // Description:
+        //      Same as the DebouncerBank functions of the same name. Readers
+        //      never see the bank in the middle of one of these calls.
+        // 
+        void SetPullType(uint32_t port, uint8_t pulledUpButtons);
+        void ButtonProcess(const uint8_t *portStatus);
+
+        // 
+        // Bank
+        // Description:
+        //      Gets the bank for queries made by the writer process itself.
+        // 
+        const DebouncerBank &Bank() const;
+
+    private:
+        SharedDebouncerBankWriter(const SharedDebouncerBankWriter &);
+        SharedDebouncerBankWriter &operator=(const SharedDebouncerBankWriter &);
+
+        DebouncerShmHeader *header;
+        size_t mappedSize;
+        DebouncerBank *bank;
+};
+
+class
+SharedDebouncerBankReader
+{
+    public:
+        SharedDebouncerBankReader();
+        ~SharedDebouncerBankReader();
+
+        // 
+        // Open
+        // Description:
+        //      Maps the named segment read only.
+        // Parameters:
+        //      name - The shm_open name of the segment.
+        // Returns:
+        //      True on success. False if the segment doesn't exist, hasn't
+        //      been fully created yet or has a layout this reader doesn't
+        //      understand.
+        // 
+        bool Open(const char *name);
+
+        // 
+        // Close
+        // Description:
+        //      Unmaps the segment. Called by the destructor.
+        // 
+        void Close();
+
+        // 
+        // Button Pressed, Button Released and Button Current
+        // Description:
+        //      Same as the DebouncerBank functions of the same name. Each call
+        //      returns the state of one complete tick.
+        // 
+        uint8_t ButtonPressed(uint32_t port, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonReleased(uint32_t port, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonCurrent(uint32_t port, uint8_t GPIOButtonPins) const;
+
+        // 
+        // Read Begin and Read Retry
+        // Description:
+        //      Lets several queries made directly on Bank() be taken from the
+        //      same tick. Query the bank between ReadBegin and ReadRetry and
+        //      start over while ReadRetry returns true:
+        // 
+        //      do
+        //      {
+        //          seq = reader.ReadBegin();
+        //          a = reader.Bank().ButtonCurrent(0, BUTTON_PIN_0);
+        //          b = reader.Bank().ButtonCurrent(7, BUTTON_PIN_3);
+        //      }
+        //      while(reader.ReadRetry(seq));
+        // 
+        uint32_t ReadBegin() const;
+        bool ReadRetry(uint32_t seq) const;
+
+        // 
+        // Ticks
+        // Description:
+        //      Gets how many times the writer has updated the bank through
+        //      ButtonProcess or SetPullType since creating the segment. Lets a
+        //      reader tell whether anything new has happened since it last
+        //      looked.
+        // 
+        uint32_t Ticks() const;
+
+        // 
+        // Bank
+        // Description:
+        //      Gets the bank in the segment.
+        // 
+        const DebouncerBank &Bank() const;
+
+    private:
+        SharedDebouncerBankReader(const SharedDebouncerBankReader &);
+        SharedDebouncerBankReader &operator=(const SharedDebouncerBankReader &);
+
+        const DebouncerShmHeader *header;
+        size_t mappedSize;
+        DebouncerBank *bank;
+};
+
+#endif  // BUTTON_DEBOUNCER_SHM_H
@@ -0,0 +1,275 @@
+//*********************************************************************************
+// State Button Debouncer - Sparse Engine
+// 
+// Revision: 1.0
+// 
+// Description: Debounces a very large number of ports while only keeping the
+// history of the ports that are actually bouncing. See
+// button_debounce_sparse.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <string.h>
+#include "button_debounce_sparse.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// The number of ports covered by one word of the unstable bitmap
+#define BUTTON_SPARSE_WORD_PORTS    64
+
+//*********************************************************************************
+// Class Functions
+//*********************************************************************************
+SparseDebouncerEngine::
+SparseDebouncerEngine(uint32_t numPorts, uint32_t maxUnstablePorts,
+                      uint8_t pulledUpButtons, DebouncerArena *arena)
+{
+    uint32_t words = (numPorts + (BUTTON_SPARSE_WORD_PORTS - 1)) / BUTTON_SPARSE_WORD_PORTS;
+
+    this->numPorts = numPorts;
+    this->arena = arena;
+    maxUnstable = maxUnstablePorts;
+    changedCapacity = (uint64_t)maxUnstable * 2 < numPorts ? maxUnstable * 2 : numPorts;
+    numUnstable = 0;
+    numChanged = 0;
+    overflows = 0;
+    index = 0;
+
+    debouncedState = DebouncerAllocate<uint8_t>(arena, numPorts);
+    changed = DebouncerAllocate<uint8_t>(arena, numPorts);
+    pullType = DebouncerAllocate<uint8_t>(arena, numPorts);
+    unstable = DebouncerAllocate<uint64_t>(arena, words);
+    slotHistory = DebouncerAllocate<uint8_t>(arena, (size_t)maxUnstable * NUM_BUTTON_STATES);
+    slotPort = DebouncerAllocate<uint32_t>(arena, maxUnstable);
+    changedPorts = DebouncerAllocate<uint32_t>(arena, changedCapacity);
+
+    memset(debouncedState, 0x00, numPorts);
+    memset(changed, 0x00, numPorts);
+    memset(pullType, pulledUpButtons, numPorts);
+    memset(unstable, 0x00, sizeof(uint64_t) * words);
+}
+
+SparseDebouncerEngine::
+~SparseDebouncerEngine()
+{
+    uint32_t words = (numPorts + (BUTTON_SPARSE_WORD_PORTS - 1)) / BUTTON_SPARSE_WORD_PORTS;
+
+    DebouncerFree(arena, debouncedState, numPorts);
+    DebouncerFree(arena, changed, numPorts);
+    DebouncerFree(arena, pullType, numPorts);
+    DebouncerFree(arena, unstable, words);
+    DebouncerFree(arena, slotHistory, (size_t)maxUnstable * NUM_BUTTON_STATES);
+    DebouncerFree(arena, slotPort, maxUnstable);
+    DebouncerFree(arena, changedPorts, changedCapacity);
+}
+
+void SparseDebouncerEngine::
+SetPullType(uint32_t port, uint8_t pulledUpButtons)
+{
+    pullType[port] = pulledUpButtons;
+}
+
+void SparseDebouncerEngine::
+Update(uint32_t port, uint8_t debounced)
+{
+    changed[port] = debounced ^ debouncedState[port];
+    debouncedState[port] = debounced;
+
+    if(changed[port] != 0 && numChanged < changedCapacity)
+    {
+        changedPorts[numChanged++] = port;
+    }
+}
+
+void SparseDebouncerEngine::
+Allocate(uint32_t port, uint8_t sample)
+{
+    uint8_t *history;
+    uint32_t slot;
+
+    if(numUnstable == maxUnstable)
+    {
+        overflows++;
+        return;
+    }
+
+    slot = numUnstable++;
+    slotPort[slot] = port;
+    unstable[port / BUTTON_SPARSE_WORD_PORTS] |= (uint64_t)1 << (port % BUTTON_SPARSE_WORD_PORTS);
+
+    // Every earlier sample of a stable port equals its debounced state
+    history = slotHistory + (size_t)slot * NUM_BUTTON_STATES;
+    memset(history, debouncedState[port], NUM_BUTTON_STATES);
+    history[index] = sample;
+
+    Update(port, debouncedState[port] & sample);
+}
+
+void SparseDebouncerEngine::
+ButtonProcess(const uint8_t *portStatus)
+{
+    uint8_t *history;
+    uint8_t sample;
+    uint8_t anded;
+    uint8_t ored;
+    uint64_t bits;
+    uint32_t port;
+    uint32_t count;
+    uint32_t slot;
+    uint32_t i;
+    uint8_t j;
+
+    // Only the ports that changed last time need their changed pins cleared
+    for(i = 0; i < numChanged; i++)
+    {
+        changed[changedPorts[i]] = 0;
+    }
+    numChanged = 0;
+
+    // Debounce the ports that have a history slot. Once a port's history
+    // agrees with itself the port is stable again and gives its slot back
+    // by moving the last slot in use into its place.
+    slot = 0;
+    while(slot < numUnstable)
+    {
+        port = slotPort[slot];
+        history = slotHistory + (size_t)slot * NUM_BUTTON_STATES;
+        history[index] = portStatus[port] ^ pullType[port];
+
+        anded = 0xFF;
+        ored = 0x00;
+        for(j = 0; j < NUM_BUTTON_STATES; j++)
+        {
+            anded &= history[j];
+            ored |= history[j];
+        }
+        Update(port, anded);
+
+        if(anded != ored)
+        {
+            slot++;
+            continue;
+        }
+
+        unstable[port / BUTTON_SPARSE_WORD_PORTS] &=
+            ~((uint64_t)1 << (port % BUTTON_SPARSE_WORD_PORTS));
+        numUnstable--;
+        if(slot != numUnstable)
+        {
+            slotPort[slot] = slotPort[numUnstable];
+            memcpy(history, slotHistory + (size_t)numUnstable * NUM_BUTTON_STATES,
+                   NUM_BUTTON_STATES);
+        }
+    }
+
+    // Look for stable ports whose sample disagrees with their debounced
+    // state. A port that just gave its slot back is stable at the value of
+    // its latest sample so it is never picked up again here.
+    for(port = 0; port < numPorts; port += count)
+    {
+        count = numPorts - port;
+        if(count > BUTTON_SPARSE_WORD_PORTS)
+        {
+            count = BUTTON_SPARSE_WORD_PORTS;
+        }
+
+        bits = 0;
+        for(i = 0; i < count; i++)
+        {
+            sample = portStatus[port + i] ^ pullType[port + i];
+            bits |= (uint64_t)(sample != debouncedState[port + i]) << i;
+        }
+        bits &= ~unstable[port / BUTTON_SPARSE_WORD_PORTS];
+
+        while(bits != 0)
+        {
+            i = __builtin_ctzll(bits);
+            bits &= bits - 1;
+            Allocate(port + i, portStatus[port + i] ^ pullType[port + i]);
+        }
+    }
+
+    // Check to make sure the index hasn't gone over the limit
+    index++;
+    if(index >= NUM_BUTTON_STATES)
+    {
+        index = 0;
+    }
+}
+
+uint8_t SparseDebouncerEngine::
+ButtonPressed(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    return (changed[port] & debouncedState[port]) & GPIOButtonPins;
+}
+
+uint8_t SparseDebouncerEngine::
+ButtonReleased(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    return (changed[port] & (~debouncedState[port])) & GPIOButtonPins;
+}
+
+uint8_t SparseDebouncerEngine::
+ButtonCurrent(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    return debouncedState[port] & GPIOButtonPins;
+}
+
+const uint32_t *SparseDebouncerEngine::
+ChangedPorts() const
+{
+    return changedPorts;
+}
+
+uint32_t SparseDebouncerEngine::
+ChangedPortCount() const
+{
+    return numChanged;
+}
+
+uint32_t SparseDebouncerEngine::
+UnstablePorts() const
+{
+    return numUnstable;
+}
+
+uint64_t SparseDebouncerEngine::
+Overflows() const
+{
+    return overflows;
+}
+
+uint32_t SparseDebouncerEngine::
+NumPorts() const
+{
+    return numPorts;
+}
@@ -0,0 +1,200 @@
+//*********************************************************************************
+// State Button Debouncer - Sparse Engine
+// 
+// Revision: 1.0
+// 
+// Description: Debounces a very large number of ports while only keeping the
+// history of the ports that are actually bouncing. A port whose last
+// NUM_BUTTON_STATES samples all agree is stable and needs nothing besides its
+// debounced state, changed pins and pull type. When a sample disagrees with
+// a stable port's debounced state, the port is given a history slot from a
+// fixed pool. The slot goes back to the pool as soon as the port's history
+// agrees with itself again, so memory grows with the number of bouncing
+// ports instead of the number of ports.
+// 
+// The results are the same as those of a Debouncer per port as long as the
+// pool never runs out. When it does, the samples that would have needed a
+// slot are dropped and counted by Overflows.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_SPARSE_H
+#define BUTTON_DEBOUNCER_SPARSE_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include "button_debounce.h"
+#include "button_debounce_arena.h"
+
+//*********************************************************************************
+// Class
+//*********************************************************************************
+
+class
+SparseDebouncerEngine
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Initializes the engine with every port stable and released.
+        // Parameters:
+        //      numPorts - The number of ports.
+        //      maxUnstablePorts - The number of history slots in the pool,
+        //          which is the most ports that can be bouncing at once.
+        //      pulledUpButtons - The pullups used on every port. See the
+        //          Debouncer constructor.
+        //      arena - Where to allocate the engine from, or NULL for the
+        //          heap.
+        // Returns:
+        //      None
+        // 
+        SparseDebouncerEngine(uint32_t numPorts, uint32_t maxUnstablePorts,
+                              uint8_t pulledUpButtons, DebouncerArena *arena = NULL);
+        ~SparseDebouncerEngine();
+
+        // 
+        // Set Pull Type
+        // Description:
+        //      Changes the pullups used on one port.
+        // 
+        void SetPullType(uint32_t port, uint8_t pulledUpButtons);
+
+        // 
+        // Button Process
+        // Description:
+        //      Debounces every port. Stable ports whose sample agrees with
+        //      their debounced state cost a compare and nothing else.
+        // Parameters:
+        //      portStatus - An array holding one status byte per port.
+        // Returns:
+        //      None
+        // 
+        void ButtonProcess(const uint8_t *portStatus);
+
+        // 
+        // Button Pressed, Button Released and Button Current
+        // Description:
+        //      Same as the Debouncer functions of the same name for one port.
+        // 
+        uint8_t ButtonPressed(uint32_t port, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonReleased(uint32_t port, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonCurrent(uint32_t port, uint8_t GPIOButtonPins) const;
+
+        // 
+        // Changed Ports and Changed Port Count
+        // Description:
+        //      Lists the ports that changed on the last call to
+        //      ButtonProcess, in no particular order.
+        // 
+        const uint32_t *ChangedPorts() const;
+        uint32_t ChangedPortCount() const;
+
+        // 
+        // Unstable Ports
+        // Description:
+        //      Gets the number of history slots in use.
+        // 
+        uint32_t UnstablePorts() const;
+
+        // 
+        // Overflows
+        // Description:
+        //      Gets the number of samples that were dropped because the pool
+        //      of history slots was empty.
+        // 
+        uint64_t Overflows() const;
+
+        // 
+        // Num Ports
+        // Description:
+        //      Gets the number of ports.
+        // 
+        uint32_t NumPorts() const;
+
+    private:
+        SparseDebouncerEngine(const SparseDebouncerEngine &);
+        SparseDebouncerEngine &operator=(const SparseDebouncerEngine &);
+
+        // 
+        // Gives a stable port whose sample disagreed a history slot
+        // 
+        void Allocate(uint32_t port, uint8_t sample);
+
+        // 
+        // Saves a port's new debounced state
+        // 
+        void Update(uint32_t port, uint8_t debounced);
+
+        uint32_t numPorts;
+        DebouncerArena *arena;
+
+        // 
+        // The debounced state, changed pins and pull type of every port
+        // 
+        uint8_t *debouncedState;
+        uint8_t *changed;
+        uint8_t *pullType;
+
+        // 
+        // One bit per port that has a history slot
+        // 
+        uint64_t *unstable;
+
+        // 
+        // The history slots. Slots 0 up to numUnstable - 1 are in use and
+        // slotPort says which port each of them belongs to.
+        // 
+        uint8_t *slotHistory;
+        uint32_t *slotPort;
+        uint32_t maxUnstable;
+        uint32_t numUnstable;
+
+        // 
+        // The ports that changed on the last tick. A slot given back during
+        // a tick can be handed to another port in the same tick, so up to
+        // twice as many ports as there are slots can change, but each port
+        // only once.
+        // 
+        uint32_t *changedPorts;
+        uint32_t numChanged;
+        uint32_t changedCapacity;
+
+        uint64_t overflows;
+
+        // 
+        // Keeps up with which history entry gets the next sample
+        // 
+        uint8_t index;
+};
+
+#endif  // BUTTON_DEBOUNCER_SPARSE_H
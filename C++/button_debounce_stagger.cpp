@@ -0,0 +1,202 @@
+//*********************************************************************************
+// State Button Debouncer - Staggered Bank
+// 
+// Revision: 1.0
+// 
+// Description: Spreads the processing of a large number of ports evenly over
+// the tick period. See button_debounce_stagger.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include "button_debounce_stagger.h"
+
+//*********************************************************************************
+// Class Functions
+//*********************************************************************************
+StaggeredDebouncerBank::
+StaggeredDebouncerBank(uint32_t numPorts, uint32_t numPhases, uint8_t pulledUpButtons,
+                       DebouncerArena *arena)
+{
+    uint32_t numGroups;
+    uint32_t i;
+
+    if(numPhases == 0)
+    {
+        numPhases = 1;
+    }
+
+    this->numPorts = numPorts;
+    this->numPhases = numPhases;
+    phase = 0;
+    this->arena = arena;
+
+    // Deal the groups of BUTTON_BANK_ALIGNMENT ports out to the phases as
+    // evenly as possible
+    numGroups = (numPorts + (BUTTON_BANK_ALIGNMENT - 1)) / BUTTON_BANK_ALIGNMENT;
+    firstPorts = DebouncerAllocate<uint32_t>(arena, numPhases + 1);
+    for(i = 0; i <= numPhases; i++)
+    {
+        firstPorts[i] = (uint32_t)((uint64_t)numGroups * i / numPhases) *
+                        BUTTON_BANK_ALIGNMENT;
+        if(firstPorts[i] > numPorts)
+        {
+            firstPorts[i] = numPorts;
+        }
+    }
+
+    phases = DebouncerAllocate<DebouncerBank *>(arena, numPhases);
+    for(i = 0; i < numPhases; i++)
+    {
+        phases[i] = DebouncerNew<DebouncerBank>(arena, PhasePorts(i), pulledUpButtons, arena);
+    }
+}
+
+StaggeredDebouncerBank::
+~StaggeredDebouncerBank()
+{
+    uint32_t i;
+
+    for(i = 0; i < numPhases; i++)
+    {
+        DebouncerDelete(arena, phases[i]);
+    }
+    DebouncerFree(arena, phases, numPhases);
+    DebouncerFree(arena, firstPorts, numPhases + 1);
+}
+
+uint32_t StaggeredDebouncerBank::
+ButtonProcess(const uint8_t *portStatus)
+{
+    uint32_t processed = phase;
+
+    phases[phase]->ButtonProcess(portStatus);
+
+    phase++;
+    if(phase >= numPhases)
+    {
+        phase = 0;
+    }
+
+    return processed;
+}
+
+uint32_t StaggeredDebouncerBank::
+CurrentPhase() const
+{
+    return phase;
+}
+
+uint32_t StaggeredDebouncerBank::
+PhaseOf(uint32_t port) const
+{
+    uint32_t low = 0;
+    uint32_t high = numPhases - 1;
+    uint32_t middle;
+
+    // Find the last phase starting at or before the port. Phases left
+    // without any ports start where the next phase starts, so the search
+    // always lands on the phase that actually holds the port.
+    while(low < high)
+    {
+        middle = (low + high + 1) / 2;
+        if(firstPorts[middle] <= port)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle - 1;
+        }
+    }
+
+    return low;
+}
+
+uint32_t StaggeredDebouncerBank::
+PhaseFirstPort(uint32_t phase) const
+{
+    return firstPorts[phase];
+}
+
+uint32_t StaggeredDebouncerBank::
+PhasePorts(uint32_t phase) const
+{
+    return firstPorts[phase + 1] - firstPorts[phase];
+}
+
+void StaggeredDebouncerBank::
+SetPullType(uint32_t port, uint8_t pulledUpButtons)
+{
+    uint32_t p = PhaseOf(port);
+
+    phases[p]->SetPullType(port - firstPorts[p], pulledUpButtons);
+}
+
+uint8_t StaggeredDebouncerBank::
+ButtonPressed(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    uint32_t p = PhaseOf(port);
+
+    return phases[p]->ButtonPressed(port - firstPorts[p], GPIOButtonPins);
+}
+
+uint8_t StaggeredDebouncerBank::
+ButtonReleased(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    uint32_t p = PhaseOf(port);
+
+    return phases[p]->ButtonReleased(port - firstPorts[p], GPIOButtonPins);
+}
+
+uint8_t StaggeredDebouncerBank::
+ButtonCurrent(uint32_t port, uint8_t GPIOButtonPins) const
+{
+    uint32_t p = PhaseOf(port);
+
+    return phases[p]->ButtonCurrent(port - firstPorts[p], GPIOButtonPins);
+}
+
+uint32_t StaggeredDebouncerBank::
+NumPorts() const
+{
+    return numPorts;
+}
+
+uint32_t StaggeredDebouncerBank::
+NumPhases() const
+{
+    return numPhases;
+}
+
+const DebouncerBank &StaggeredDebouncerBank::
+PhaseBank(uint32_t phase) const
+{
+    return *phases[phase];
+}
@@ -0,0 +1,175 @@
+//*********************************************************************************
+// State Button Debouncer - Staggered Bank
+// 
+// Revision: 1.0
+// 
+// Description: Spreads the processing of a large number of ports evenly over
+// the tick period instead of doing all of it at the start of every tick. The
+// ports are split into numPhases slices, and the tick period is split into
+// numPhases sub-ticks. Each sub-tick debounces only one slice:
+// 
+//      // Every 1 millisecond / numPhases
+//      phase = ports.CurrentPhase();
+//      ReadPorts(ports.PhaseFirstPort(phase), ports.PhasePorts(phase), status);
+//      ports.ButtonProcess(status);
+// 
+// Every port is still debounced exactly once per tick period, always at the
+// same point in it, so the time between two samples of a port doesn't change.
+// What changes is that the work (and the latency of the sub-tick that does it)
+// is numPhases times smaller.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_STAGGER_H
+#define BUTTON_DEBOUNCER_STAGGER_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include "button_debounce_bank.h"
+
+//*********************************************************************************
+// Class
+//*********************************************************************************
+
+class
+StaggeredDebouncerBank
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Splits numPorts ports into numPhases slices of about the same
+        //      size. Slices are made of whole groups of BUTTON_BANK_ALIGNMENT
+        //      ports (except for the end of the last slice) so that no two
+        //      phases touch the same cache line.
+        // Parameters:
+        //      numPorts - The total number of ports.
+        //      numPhases - The number of sub-ticks per tick period.
+        //      pulledUpButtons - The pullups used on every port.
+        //      arena - Where to allocate the phases from, or NULL for the
+        //          heap.
+        // Returns:
+        //      None
+        // 
+        StaggeredDebouncerBank(uint32_t numPorts, uint32_t numPhases,
+                               uint8_t pulledUpButtons, DebouncerArena *arena = NULL);
+        ~StaggeredDebouncerBank();
+
+        // 
+        // Button Process
+        // Description:
+        //      Debounces the slice of the current phase and moves on to the
+        //      next phase. Should be called once per sub-tick, that is
+        //      numPhases times per tick period.
+        // Parameters:
+        //      portStatus - One status byte per port of the current phase's
+        //          slice. portStatus[0] belongs to PhaseFirstPort(phase).
+        // Returns:
+        //      The phase that was processed.
+        // 
+        uint32_t ButtonProcess(const uint8_t *portStatus);
+
+        // 
+        // Current Phase
+        // Description:
+        //      Gets the phase the next ButtonProcess call processes.
+        // 
+        uint32_t CurrentPhase() const;
+
+        // 
+        // Phase Of, Phase First Port and Phase Ports
+        // Description:
+        //      Get the phase a port is processed in and the ports of a phase.
+        // 
+        uint32_t PhaseOf(uint32_t port) const;
+        uint32_t PhaseFirstPort(uint32_t phase) const;
+        uint32_t PhasePorts(uint32_t phase) const;
+
+        // 
+        // Set Pull Type
+        // Description:
+        //      Changes the pullups used on one port.
+        // Parameters:
+        //      port - The port.
+        //      pulledUpButtons - See the Debouncer constructor.
+        // Returns:
+        //      None
+        // 
+        void SetPullType(uint32_t port, uint8_t pulledUpButtons);
+
+        // 
+        // Button Pressed, Button Released and Button Current
+        // Description:
+        //      Same as the DebouncerBank functions of the same name. Presses
+        //      and releases stay visible until the port's phase comes around
+        //      again.
+        // 
+        uint8_t ButtonPressed(uint32_t port, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonReleased(uint32_t port, uint8_t GPIOButtonPins) const;
+        uint8_t ButtonCurrent(uint32_t port, uint8_t GPIOButtonPins) const;
+
+        // 
+        // Num Ports and Num Phases
+        // 
+        uint32_t NumPorts() const;
+        uint32_t NumPhases() const;
+
+        // 
+        // Phase Bank
+        // Description:
+        //      Gets the bank holding one phase's slice, for example to publish
+        //      its events right after the phase has been processed. Port i of
+        //      the bank is port PhaseFirstPort(phase) + i.
+        // 
+        const DebouncerBank &PhaseBank(uint32_t phase) const;
+
+    private:
+        StaggeredDebouncerBank(const StaggeredDebouncerBank &);
+        StaggeredDebouncerBank &operator=(const StaggeredDebouncerBank &);
+
+        // 
+        // One bank per phase, each with its own place in its state arrays
+        // 
+        DebouncerBank **phases;
+        uint32_t numPhases;
+        uint32_t numPorts;
+
+        // 
+        // The first port of each phase, followed by numPorts
+        // 
+        uint32_t *firstPorts;
+
+        uint32_t phase;
+        DebouncerArena *arena;
+};
+
+#endif  // BUTTON_DEBOUNCER_STAGGER_H
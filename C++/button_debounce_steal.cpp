@@ -0,0 +1,314 @@
+//*********************************************************************************
+// State Button Debouncer - Work Stealing Executor
+// 
+// Revision: 1.0
+// 
+// Description: Spreads the processing of one DebouncerBank tick over several
+// threads. See button_debounce_steal.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stddef.h>
+#include "button_debounce_steal.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// Returned by Pop and Steal when no range was taken
+#define NO_RANGE    (-1)
+
+//*********************************************************************************
+// Class Functions
+//*********************************************************************************
+WorkStealingBankExecutor::
+WorkStealingBankExecutor(DebouncerBank &bank, uint32_t numWorkers, uint32_t grainPorts) :
+    bank(bank)
+{
+    uint32_t i;
+
+    if(numWorkers == 0)
+    {
+        numWorkers = 1;
+    }
+
+    this->numWorkers = numWorkers;
+    grain = (grainPorts + (BUTTON_BANK_ALIGNMENT - 1)) &
+            ~(uint32_t)(BUTTON_BANK_ALIGNMENT - 1);
+    if(grain == 0)
+    {
+        grain = BUTTON_BANK_ALIGNMENT;
+    }
+    numRanges = (bank.NumPorts() + grain - 1) / grain;
+
+    rangeHandler = NULL;
+    rangeContext = NULL;
+    status.store(NULL, std::memory_order_relaxed);
+    remaining.store(0, std::memory_order_relaxed);
+    stolen.store(0, std::memory_order_relaxed);
+    active.store(0, std::memory_order_relaxed);
+    tick = 0;
+    stopping = false;
+
+    // The queues are cache line aligned, which new only honours from C++17 on
+    workers = DebouncerAllocate<Worker>(NULL, numWorkers);
+    for(i = 0; i < numWorkers; i++)
+    {
+        workers[i].top.store(0, std::memory_order_relaxed);
+        workers[i].bottom.store(0, std::memory_order_relaxed);
+    }
+
+    // Worker 0 is whichever thread calls ButtonProcess
+    for(i = 1; i < numWorkers; i++)
+    {
+        workers[i].thread = std::thread(&WorkStealingBankExecutor::WorkerThread,
+                                        this, i);
+    }
+}
+
+WorkStealingBankExecutor::
+~WorkStealingBankExecutor()
+{
+    uint32_t i;
+
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        stopping = true;
+    }
+    start.notify_all();
+
+    for(i = 1; i < numWorkers; i++)
+    {
+        workers[i].thread.join();
+    }
+
+    DebouncerFree(NULL, workers, numWorkers);
+}
+
+void WorkStealingBankExecutor::
+SetRangeHandler(DebouncerRangeHandler handler, void *context)
+{
+    rangeHandler = handler;
+    rangeContext = context;
+}
+
+int64_t WorkStealingBankExecutor::
+Pop(Worker *worker)
+{
+    int64_t bottom = worker->bottom.load(std::memory_order_relaxed) - 1;
+    int64_t top;
+    bool won;
+
+    // Claim the bottom range before looking at what the thieves are doing
+    worker->bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    top = worker->top.load(std::memory_order_relaxed);
+
+    if(top > bottom)
+    {
+        // Empty
+        worker->bottom.store(bottom + 1, std::memory_order_relaxed);
+        return NO_RANGE;
+    }
+
+    if(top == bottom)
+    {
+        // The last range. Race the thieves for it. Either way the queue is
+        // left empty with bottom one past the range. A failed exchange
+        // overwrites top with a thief's value, so top can't be used for
+        // that.
+        won = worker->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                  std::memory_order_relaxed);
+        worker->bottom.store(bottom + 1, std::memory_order_relaxed);
+        if(!won)
+        {
+            return NO_RANGE;
+        }
+    }
+
+    return bottom;
+}
+
+int64_t WorkStealingBankExecutor::
+Steal(Worker *victim, bool *empty)
+{
+    int64_t top = victim->top.load(std::memory_order_acquire);
+    int64_t bottom;
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bottom = victim->bottom.load(std::memory_order_acquire);
+
+    if(top >= bottom)
+    {
+        return NO_RANGE;
+    }
+
+    // The queue isn't empty, even if another thief wins the range below
+    *empty = false;
+    if(!victim->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                            std::memory_order_relaxed))
+    {
+        return NO_RANGE;
+    }
+
+    return top;
+}
+
+void WorkStealingBankExecutor::
+ProcessRange(int64_t range)
+{
+    uint32_t firstPort = (uint32_t)range * grain;
+    uint32_t count = bank.NumPorts() - firstPort;
+
+    if(count > grain)
+    {
+        count = grain;
+    }
+
+    bank.ButtonProcessRange(firstPort, count,
+                            status.load(std::memory_order_acquire) + firstPort);
+
+    if(rangeHandler != NULL)
+    {
+        rangeHandler(bank, firstPort, count, rangeContext);
+    }
+
+    remaining.fetch_sub(1, std::memory_order_release);
+}
+
+void WorkStealingBankExecutor::
+Work(uint32_t self)
+{
+    int64_t range;
+    uint32_t victim;
+    uint32_t i;
+    bool empty;
+
+    // Own ranges first
+    while((range = Pop(&workers[self])) != NO_RANGE)
+    {
+        ProcessRange(range);
+    }
+
+    // Then everybody else's, starting with the next worker over so that the
+    // thieves don't all go after the same victim
+    do
+    {
+        empty = true;
+
+        for(i = 1; i < numWorkers; i++)
+        {
+            victim = (self + i) % numWorkers;
+            while((range = Steal(&workers[victim], &empty)) != NO_RANGE)
+            {
+                ProcessRange(range);
+                stolen.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    while(!empty);
+}
+
+void WorkStealingBankExecutor::
+WorkerThread(uint32_t self)
+{
+    uint64_t lastTick = 0;
+
+    while(1)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while(!stopping && tick == lastTick)
+            {
+                start.wait(lock);
+            }
+
+            if(stopping)
+            {
+                return;
+            }
+
+            lastTick = tick;
+        }
+
+        Work(self);
+        active.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void WorkStealingBankExecutor::
+ButtonProcess(const uint8_t *portStatus)
+{
+    uint32_t i;
+
+    // Workers that ran out of ranges of the last tick may still be looking
+    // for more to steal. Wait for them to give up before refilling the
+    // queues.
+    while(active.load(std::memory_order_acquire) != 0)
+    {
+        std::this_thread::yield();
+    }
+
+    status.store(portStatus, std::memory_order_release);
+    remaining.store(numRanges, std::memory_order_relaxed);
+    active.store(numWorkers - 1, std::memory_order_relaxed);
+
+    // Hand every worker a contiguous share of the ranges
+    for(i = 0; i < numWorkers; i++)
+    {
+        workers[i].top.store((int64_t)numRanges * i / numWorkers,
+                             std::memory_order_relaxed);
+        workers[i].bottom.store((int64_t)numRanges * (i + 1) / numWorkers,
+                                std::memory_order_relaxed);
+    }
+
+    // The mutex makes everything above visible to the workers
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        tick++;
+    }
+    start.notify_all();
+
+    Work(0);
+
+    // Wait for ranges still being worked on by the other workers
+    while(remaining.load(std::memory_order_acquire) != 0)
+    {
+        std::this_thread::yield();
+    }
+
+    bank.AdvanceIndex();
+}
+
+uint64_t WorkStealingBankExecutor::
+StolenRanges() const
+{
+    return stolen.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,220 @@
+//*********************************************************************************
+// State Button Debouncer - Work Stealing Executor
+// 
+// Revision: 1.0
+// 
+// Description: Spreads the processing of one DebouncerBank tick over several
+// threads. The bank is cut into small ranges of ports and every worker thread
+// starts the tick with its own share of them in a double ended queue. A worker
+// takes ranges from the back of its own queue. Once its queue is empty, it
+// steals ranges from the front of the other workers' queues. A tick therefore
+// finishes when the total amount of work is done rather than when the worker
+// with the busiest ports is done.
+// 
+// Debouncing costs the same for every port, but what the application does
+// with the results usually doesn't. A range handler can be given that is
+// called for every range right after it is debounced, by the same worker, so
+// that per port event handling is balanced across the workers too.
+// 
+// Requires C++17.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_STEAL_H
+#define BUTTON_DEBOUNCER_STEAL_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "button_debounce_bank.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// 
+// Called for every range of ports once it has been debounced. Called from
+// several threads at once, each with a different range.
+// 
+typedef void (*DebouncerRangeHandler)(const DebouncerBank &bank, uint32_t firstPort,
+                                      uint32_t numPorts, void *context);
+
+//*********************************************************************************
+// Class
+//*********************************************************************************
+
+class
+WorkStealingBankExecutor
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Starts the worker threads.
+        // Parameters:
+        //      bank - The bank to process. Only this executor may process it.
+        //      numWorkers - The number of threads working on each tick,
+        //          counting the thread that calls ButtonProcess. numWorkers - 1
+        //          threads are started.
+        //      grainPorts - The number of ports in each range. Rounded up to
+        //          a multiple of BUTTON_BANK_ALIGNMENT so that no two ranges
+        //          share a cache line. Smaller ranges balance better but cost
+        //          more to hand out.
+        // Returns:
+        //      None
+        // 
+        WorkStealingBankExecutor(DebouncerBank &bank, uint32_t numWorkers,
+                                 uint32_t grainPorts);
+
+        // 
+        // Destructor
+        // Description:
+        //      Stops the worker threads.
+        // 
+        ~WorkStealingBankExecutor();
+
+        // 
+        // Set Range Handler
+        // Description:
+        //      Sets the function called for every range after it has been
+        //      debounced. Must not be called during ButtonProcess.
+        // Parameters:
+        //      handler - The handler, or NULL for none.
+        //      context - Passed to the handler.
+        // Returns:
+        //      None
+        // 
+        void SetRangeHandler(DebouncerRangeHandler handler, void *context);
+
+        // 
+        // Button Process
+        // Description:
+        //      Same as DebouncerBank::ButtonProcess, with the work shared by
+        //      all of the workers. Returns once every port has been
+        //      debounced and every range handler call has returned.
+        // Parameters:
+        //      portStatus - An array holding one status byte per port.
+        // Returns:
+        //      None
+        // 
+        void ButtonProcess(const uint8_t *portStatus);
+
+        // 
+        // Stolen Ranges
+        // Description:
+        //      Gets the number of ranges that were processed by a worker other
+        //      than the one they were handed to. Useful for tuning grainPorts.
+        // 
+        uint64_t StolenRanges() const;
+
+    private:
+        WorkStealingBankExecutor(const WorkStealingBankExecutor &);
+        WorkStealingBankExecutor &operator=(const WorkStealingBankExecutor &);
+
+        // 
+        // A worker's queue of ranges. The queue holds the range numbers from
+        // top up to but not including bottom. The owner takes from the
+        // bottom and thieves take from the top, each on its own cache line.
+        // 
+        struct
+        Worker
+        {
+            alignas(BUTTON_BANK_ALIGNMENT) std::atomic<int64_t> top;
+            alignas(BUTTON_BANK_ALIGNMENT) std::atomic<int64_t> bottom;
+            std::thread thread;
+        };
+
+        // 
+        // Takes a range from the bottom of a worker's own queue
+        // 
+        int64_t Pop(Worker *worker);
+
+        // 
+        // Takes a range from the top of another worker's queue
+        // 
+        int64_t Steal(Worker *victim, bool *empty);
+
+        // 
+        // Works on the current tick until no ranges are left anywhere
+        // 
+        void Work(uint32_t self);
+
+        // 
+        // Debounces one range and calls the range handler
+        // 
+        void ProcessRange(int64_t range);
+
+        // 
+        // What the started threads run
+        // 
+        void WorkerThread(uint32_t self);
+
+        DebouncerBank &bank;
+        Worker *workers;
+        uint32_t numWorkers;
+        uint32_t grain;
+        uint32_t numRanges;
+
+        DebouncerRangeHandler rangeHandler;
+        void *rangeContext;
+
+        // 
+        // The current tick's port statuses
+        // 
+        std::atomic<const uint8_t *> status;
+
+        // 
+        // Ranges of the current tick that haven't been finished yet
+        // 
+        alignas(BUTTON_BANK_ALIGNMENT) std::atomic<int64_t> remaining;
+        std::atomic<uint64_t> stolen;
+
+        // 
+        // Started workers that haven't left Work for the current tick yet.
+        // The queues are only refilled once this is 0, so that a thief still
+        // looking for ranges of the last tick can't take one of the next.
+        // 
+        std::atomic<uint32_t> active;
+
+        // 
+        // Starting ticks and stopping the workers
+        // 
+        std::mutex mutex;
+        std::condition_variable start;
+        uint64_t tick;
+        bool stopping;
+};
+
+#endif  // BUTTON_DEBOUNCER_STEAL_H
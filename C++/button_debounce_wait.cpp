@@ -0,0 +1,285 @@
+//*********************************************************************************
+// State Button Debouncer - Blocking Wait
+// 
+// Revision: 1.0
+// 
+// Description: Lets threads sleep until a button is pressed or released. See
+// button_debounce_wait.h for details.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "button_debounce_wait.h"
+
+//*********************************************************************************
+// Local Functions
+//*********************************************************************************
+
+// 
+// Spreads the 8 pins of a port out into the lowest bit of each byte of a
+// 64 bit word: pin 0 goes to bit 0, pin 1 to bit 8 and so on
+// 
+static uint64_t
+SpreadPins(uint8_t pins)
+{
+    uint64_t spread = 0;
+    uint8_t i;
+
+    for(i = 0; i < 8; i++)
+    {
+        if(pins & (1 << i))
+        {
+            spread |= (uint64_t)1 << (i * 8);
+        }
+    }
+
+    return spread;
+}
+
+// 
+// The opposite of SpreadPins: a 1 bit for every byte that isn't 0
+// 
+static uint8_t
+NonZeroPins(uint64_t counts)
+{
+    uint8_t pins = 0;
+    uint8_t i;
+
+    for(i = 0; i < 8; i++)
+    {
+        if((counts >> (i * 8)) & 0xFF)
+        {
+            pins |= (1 << i);
+        }
+    }
+
+    return pins;
+}
+
+// 
+// Adds a spread out set of pins to per pin byte counters. Each byte wraps
+// around at 256 without carrying into the byte of the next pin.
+// 
+static uint64_t
+CountPins(uint64_t counts, uint64_t spread)
+{
+    const uint64_t high = 0x8080808080808080ULL;
+
+    return ((counts & ~high) + spread) ^ (counts & high);
+}
+
+//*********************************************************************************
+// Class Functions
+//*********************************************************************************
+DebouncerWaitTable::
+DebouncerWaitTable(uint32_t numPorts, DebouncerArena *arena)
+{
+    uint32_t i;
+
+    this->numPorts = numPorts;
+    this->arena = arena;
+    ports = DebouncerAllocate<PortState>(arena, numPorts);
+
+    for(i = 0; i < numPorts; i++)
+    {
+        ports[i].generation.store(0, std::memory_order_relaxed);
+        ports[i].state.store(0, std::memory_order_relaxed);
+        ports[i].waiting.store(0, std::memory_order_relaxed);
+        ports[i].presses.store(0, std::memory_order_relaxed);
+        ports[i].releases.store(0, std::memory_order_relaxed);
+    }
+}
+
+DebouncerWaitTable::
+~DebouncerWaitTable()
+{
+    DebouncerFree(arena, ports, numPorts);
+}
+
+void DebouncerWaitTable::
+Publish(uint32_t port, uint8_t debouncedState, uint8_t changedPins)
+{
+    PortState *p = &ports[port];
+    uint8_t wake;
+
+    if(changedPins == 0)
+    {
+        return;
+    }
+
+    // Only this thread writes the counters, so they don't need atomic
+    // read-modify-writes
+    p->state.store(debouncedState, std::memory_order_relaxed);
+    p->presses.store(CountPins(p->presses.load(std::memory_order_relaxed),
+                               SpreadPins(changedPins & debouncedState)),
+                     std::memory_order_relaxed);
+    p->releases.store(CountPins(p->releases.load(std::memory_order_relaxed),
+                                SpreadPins(changedPins & ~debouncedState)),
+                      std::memory_order_relaxed);
+
+    // Either a waiter that is just starting to wait sees the state stored
+    // above, or this thread sees that it is waiting and wakes it up
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    wake = changedPins & NonZeroPins(p->waiting.load(std::memory_order_relaxed));
+    if(wake != 0)
+    {
+        p->generation.fetch_add(1, std::memory_order_release);
+
+        // Only threads waiting on one of the pins in wake are woken up
+        syscall(SYS_futex, &p->generation, FUTEX_WAKE_BITSET | FUTEX_PRIVATE_FLAG,
+                INT_MAX, NULL, NULL, (uint32_t)wake);
+    }
+}
+
+void DebouncerWaitTable::
+Publish(uint32_t port, Debouncer &debouncer)
+{
+    Publish(port, debouncer.ButtonCurrent(0xFF),
+            debouncer.ButtonPressed(0xFF) | debouncer.ButtonReleased(0xFF));
+}
+
+void DebouncerWaitTable::
+Publish(const DebouncerBank &bank, uint32_t portOffset)
+{
+    const uint8_t *changed = bank.ChangedStates();
+    const uint8_t *debounced = bank.DebouncedStates();
+    DebouncerBank::ChangedIterator it(bank, 0);
+    uint32_t port;
+
+    while(it.Next(port))
+    {
+        Publish(portOffset + port, debounced[port], changed[port]);
+    }
+}
+
+uint8_t DebouncerWaitTable::
+Check(uint32_t port, uint8_t GPIOButtonPins, uint8_t condition,
+      uint64_t pressesBefore, uint64_t releasesBefore) const
+{
+    const PortState *p = &ports[port];
+
+    switch(condition)
+    {
+        case BUTTON_WAIT_PRESSED:
+            return NonZeroPins(p->presses.load(std::memory_order_relaxed) ^
+                               pressesBefore) & GPIOButtonPins;
+
+        case BUTTON_WAIT_RELEASED:
+            return NonZeroPins(p->releases.load(std::memory_order_relaxed) ^
+                               releasesBefore) & GPIOButtonPins;
+
+        case BUTTON_WAIT_DOWN:
+            return p->state.load(std::memory_order_relaxed) & GPIOButtonPins;
+
+        default:
+            return ~p->state.load(std::memory_order_relaxed) & GPIOButtonPins;
+    }
+}
+
+uint8_t DebouncerWaitTable::
+WaitFor(uint32_t port, uint8_t GPIOButtonPins, uint8_t condition, int32_t timeoutMs)
+{
+    PortState *p = &ports[port];
+    uint64_t spread = SpreadPins(GPIOButtonPins);
+    struct timespec deadline;
+    uint64_t waiting;
+    uint64_t pressesBefore;
+    uint64_t releasesBefore;
+    uint32_t generation;
+    uint8_t pins;
+
+    if(GPIOButtonPins == 0)
+    {
+        return 0;
+    }
+
+    // FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC deadline
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    if(timeoutMs >= 0)
+    {
+        deadline.tv_sec += timeoutMs / 1000;
+        deadline.tv_nsec += (timeoutMs % 1000) * 1000000L;
+        if(deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    // Let the publisher know these pins are being waited on before looking
+    // at the state. A full byte would carry into the next pin's count, so
+    // give up instead.
+    waiting = p->waiting.load(std::memory_order_relaxed);
+    do
+    {
+        if(NonZeroPins(~waiting & (spread * BUTTON_WAIT_MAX_WAITERS)) !=
+           GPIOButtonPins)
+        {
+            return 0;
+        }
+    }
+    while(!p->waiting.compare_exchange_weak(waiting, waiting + spread,
+                                            std::memory_order_seq_cst));
+    pressesBefore = p->presses.load(std::memory_order_relaxed);
+    releasesBefore = p->releases.load(std::memory_order_relaxed);
+
+    while(1)
+    {
+        generation = p->generation.load(std::memory_order_acquire);
+
+        pins = Check(port, GPIOButtonPins, condition, pressesBefore, releasesBefore);
+        if(pins != 0)
+        {
+            break;
+        }
+
+        // Sleeps unless the generation has already moved on. Only a wake up
+        // for one of the pins in GPIOButtonPins ends the sleep early.
+        if(syscall(SYS_futex, &p->generation,
+                   FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG, generation,
+                   timeoutMs >= 0 ? &deadline : NULL, NULL,
+                   (uint32_t)GPIOButtonPins) != 0 && errno == ETIMEDOUT)
+        {
+            pins = Check(port, GPIOButtonPins, condition, pressesBefore,
+                         releasesBefore);
+            break;
+        }
+    }
+
+    p->waiting.fetch_sub(spread, std::memory_order_relaxed);
+
+    return pins;
+}
@@ -0,0 +1,203 @@
+//*********************************************************************************
+// State Button Debouncer - Blocking Wait
+// 
+// Revision: 1.0
+// 
+// Description: Lets threads sleep until a button is pressed or released
+// instead of polling ButtonCurrent. The thread that calls ButtonProcess
+// publishes the results into a wait table, and any other thread can call
+// WaitFor to block until pins of a port reach a state or see an edge.
+// 
+// Each port has its own Linux futex, and a sleeping thread is only woken up
+// when a pin it is waiting for changes. Publishing costs no system call at
+// all when nobody is waiting for the pins that changed.
+// 
+// Publish must only be called from one thread. WaitFor may be called from any
+// number of threads, but no more than BUTTON_WAIT_MAX_WAITERS threads can wait
+// on the same pin of the same port at once. Requires Linux and C++11.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_WAIT_H
+#define BUTTON_DEBOUNCER_WAIT_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include <atomic>
+#include "button_debounce.h"
+#include "button_debounce_bank.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// Conditions for WaitFor
+#define BUTTON_WAIT_PRESSED     0   // One of the pins gets pressed
+#define BUTTON_WAIT_RELEASED    1   // One of the pins gets released
+#define BUTTON_WAIT_DOWN        2   // One of the pins is or becomes pressed
+#define BUTTON_WAIT_UP          3   // One of the pins is or becomes released
+
+// The most threads that can wait on one pin of a port at once. Each pin's
+// count of waiting threads is one byte.
+#define BUTTON_WAIT_MAX_WAITERS 255
+
+//*********************************************************************************
+// Class
+//*********************************************************************************
+
+class
+DebouncerWaitTable
+{
+    public:
+        // 
+        // Constructor
+        // Description:
+        //      Initializes a table in which every pin is released.
+        // Parameters:
+        //      numPorts - The number of ports. Ports are numbered from 0 to
+        //          numPorts - 1.
+        //      arena - Where to allocate the table from, or NULL for the
+        //          heap.
+        // Returns:
+        //      None
+        // 
+        DebouncerWaitTable(uint32_t numPorts, DebouncerArena *arena = NULL);
+        ~DebouncerWaitTable();
+
+        // 
+        // Publish
+        // Description:
+        //      Makes the result of a ButtonProcess call visible to waiting
+        //      threads and wakes up the ones waiting for a pin that changed.
+        // Parameters:
+        //      port - The port.
+        //      debouncedState - The debounced state of the port's pins, as
+        //          returned by ButtonCurrent(0xFF).
+        //      changedPins - The pins that just changed.
+        // Returns:
+        //      None
+        // 
+        void Publish(uint32_t port, uint8_t debouncedState, uint8_t changedPins);
+
+        // 
+        // Publish
+        // Description:
+        //      Same as above, taking the state from a Debouncer.
+        // Parameters:
+        //      port - The port the Debouncer debounces.
+        //      debouncer - The Debouncer instantiation.
+        // Returns:
+        //      None
+        // 
+        void Publish(uint32_t port, Debouncer &debouncer);
+
+        // 
+        // Publish
+        // Description:
+        //      Same as above for every port of a bank that changed. Bank port
+        //      i is published as port portOffset + i.
+        // Parameters:
+        //      bank - The bank.
+        //      portOffset - The port number of the bank's first port.
+        // Returns:
+        //      None
+        // 
+        void Publish(const DebouncerBank &bank, uint32_t portOffset);
+
+        // 
+        // Wait For
+        // Description:
+        //      Blocks the calling thread until one of the given pins of a port
+        //      meets the condition or the timeout runs out. The edge
+        //      conditions only count edges published after the call was made.
+        // Parameters:
+        //      port - The port.
+        //      GPIOButtonPins - The ORed combination of BUTTON_PIN_*.
+        //      condition - One of the BUTTON_WAIT_* conditions.
+        //      timeoutMs - The most milliseconds to wait, or a negative
+        //          number to wait for as long as it takes.
+        // Returns:
+        //      The pins that met the condition, or 0 if the timeout ran out
+        //      first. Also 0, without waiting, if BUTTON_WAIT_MAX_WAITERS
+        //      threads are already waiting on one of the pins.
+        // 
+        uint8_t WaitFor(uint32_t port, uint8_t GPIOButtonPins, uint8_t condition,
+                        int32_t timeoutMs);
+
+    private:
+        DebouncerWaitTable(const DebouncerWaitTable &);
+        DebouncerWaitTable &operator=(const DebouncerWaitTable &);
+
+        // 
+        // Checks the condition against a port's published state
+        // 
+        uint8_t Check(uint32_t port, uint8_t GPIOButtonPins, uint8_t condition,
+                      uint64_t pressesBefore, uint64_t releasesBefore) const;
+
+        // 
+        // The state of one port as seen by waiting threads. The counters
+        // have one byte per pin (pin 0 in the lowest byte).
+        // 
+        struct
+        PortState
+        {
+            // 
+            // The futex word. Bumped whenever a pin that somebody waits for
+            // changes.
+            // 
+            std::atomic<uint32_t> generation;
+
+            // 
+            // The debounced state of the pins
+            // 
+            std::atomic<uint8_t> state;
+
+            // 
+            // The number of threads waiting on each pin
+            // 
+            std::atomic<uint64_t> waiting;
+
+            // 
+            // The number of presses and releases of each pin so far, wrapping
+            // around at 256. Lets a waiter tell that an edge happened even
+            // when the pin changed back before it got to run.
+            // 
+            std::atomic<uint64_t> presses;
+            std::atomic<uint64_t> releases;
+        };
+
+        PortState *ports;
+        uint32_t numPorts;
+        DebouncerArena *arena;
+};
+
+#endif  // BUTTON_DEBOUNCER_WAIT_H
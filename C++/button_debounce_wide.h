@@ -0,0 +1,545 @@
+//*********************************************************************************
+// State Button Debouncer - Wide Ports
+// 
+// Revision: 1.0
+// 
+// Description: A Debouncer for one logical port of any number of pins, such
+// as a panel of 512 switches read as a single frame. The pins are held in a
+// ButtonPinSet, a fixed size array of 64 bit words aligned for vector loads.
+// Every operation is a loop over the words with a length known at compile
+// time, so the compiler unrolls it into full width vector instructions: a
+// 512 pin set is one AVX-512 register or two AVX2 registers.
+// 
+// Pins that are set in a result are visited with NextPin, which skips whole
+// words without pins and finds the rest with count trailing zeros.
+// 
+// Everything is a template, so this header holds the whole implementation.
+// 
+// Requires C++11.
+// 
+// Revisions can be found here:
+// https://github.com/tcleg
+// 
+// Copyright (C) 2014 Trent Cleghorn , <trentoncleghorn@gmail.com>
+// 
+//                                  MIT License
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//*********************************************************************************
+
+// 
+// Header Guard
+// 
+#ifndef BUTTON_DEBOUNCER_WIDE_H
+#define BUTTON_DEBOUNCER_WIDE_H
+
+//*********************************************************************************
+// Headers
+//*********************************************************************************
+#include <stdint.h>
+#include "button_debounce.h"
+
+//*********************************************************************************
+// Macros and Globals
+//*********************************************************************************
+
+// The number of pins in one word of a ButtonPinSet
+#define BUTTON_WIDE_WORD_BITS       64
+
+// The alignment of a ButtonPinSet, the size of the widest vector registers
+#define BUTTON_WIDE_ALIGNMENT       64
+
+//*********************************************************************************
+// Classes
+//*********************************************************************************
+
+// 
+// A set of NumPins pins. Pin i is bit i % 64 of word i / 64. Bits past the
+// last pin are always 0.
+// 
+template<uint32_t NumPins>
+class alignas(BUTTON_WIDE_ALIGNMENT)
+ButtonPinSet
+{
+    public:
+        static const uint32_t NumWords =
+            (NumPins + (BUTTON_WIDE_WORD_BITS - 1)) / BUTTON_WIDE_WORD_BITS;
+
+        // 
+        // Constructor
+        // Description:
+        //      Initializes a set without any pins.
+        // 
+        ButtonPinSet();
+
+        // 
+        // All
+        // Description:
+        //      Gets a set of every pin.
+        // 
+        static ButtonPinSet All();
+
+        // 
+        // Load Bytes
+        // Description:
+        //      Fills the set from (NumPins + 7) / 8 bytes, pin i being bit
+        //      i % 8 of byte i / 8, the order a chain of 8 bit shift
+        //      registers or ports is read in.
+        // Parameters:
+        //      bytes - The bytes.
+        // Returns:
+        //      None
+        // 
+        void LoadBytes(const uint8_t *bytes);
+
+        // 
+        // Set, Clear and Test
+        // Description:
+        //      Add a pin to the set, take it out and check whether it is in
+        //      the set.
+        // 
+        void Set(uint32_t pin);
+        void Clear(uint32_t pin);
+        bool Test(uint32_t pin) const;
+
+        // 
+        // Any and Count
+        // Description:
+        //      Check whether the set has any pins and count them.
+        // 
+        bool Any() const;
+        uint32_t Count() const;
+
+        // 
+        // Next Pin
+        // Description:
+        //      Finds the first pin of the set at or after a pin:
+        // 
+        //          for(pin = set.NextPin(0); pin < NumPins; pin = set.NextPin(pin + 1))
+        // 
+        // Parameters:
+        //      pin - The pin to start looking at.
+        // Returns:
+        //      The pin, or NumPins if there are no more.
+        // 
+        uint32_t NextPin(uint32_t pin) const;
+
+        // 
+        // Word
+        // Description:
+        //      Gives direct access to the words of the set. Bits past the
+        //      last pin must be left at 0.
+        // 
+        uint64_t &Word(uint32_t word);
+        uint64_t Word(uint32_t word) const;
+
+        ButtonPinSet operator&(const ButtonPinSet &other) const;
+        ButtonPinSet operator|(const ButtonPinSet &other) const;
+        ButtonPinSet operator^(const ButtonPinSet &other) const;
+        ButtonPinSet operator~() const;
+        ButtonPinSet &operator&=(const ButtonPinSet &other);
+        bool operator==(const ButtonPinSet &other) const;
+        bool operator!=(const ButtonPinSet &other) const;
+
+    private:
+        // 
+        // Gets the bits of the last word that belong to pins
+        // 
+        static uint64_t LastWordMask();
+
+        uint64_t words[NumWords];
+};
+
+// 
+// The Debouncer for a port of NumPins pins. Works the same as Debouncer with
+// ButtonPinSet in place of the 8 bit port status and BUTTON_PIN_* masks.
+// 
+template<uint32_t NumPins>
+class
+WideDebouncer
+{
+    public:
+        typedef ButtonPinSet<NumPins> PinSet;
+
+        // 
+        // Constructor
+        // Description:
+        //      Initializes the Debouncer instantiation.
+        // Parameters:
+        //      pulledUpButtons - The pins being pulled up. See the Debouncer
+        //          constructor.
+        // Returns:
+        //      None
+        // 
+        WideDebouncer(const PinSet &pulledUpButtons);
+
+        // 
+        // Button Process
+        // Description:
+        //      Debounces the port. Should be called on a regular interval.
+        // Parameters:
+        //      portStatus - The port's status.
+        // Returns:
+        //      None
+        // 
+        void ButtonProcess(const PinSet &portStatus);
+
+        // 
+        // Button Pressed, Button Released and Button Current
+        // Description:
+        //      Same as the Debouncer functions of the same name.
+        // Parameters:
+        //      GPIOButtonPins - The pins to check, or PinSet::All().
+        // Returns:
+        //      The pins just pressed, just released or currently pressed.
+        // 
+        PinSet ButtonPressed(const PinSet &GPIOButtonPins) const;
+        PinSet ButtonReleased(const PinSet &GPIOButtonPins) const;
+        PinSet ButtonCurrent(const PinSet &GPIOButtonPins) const;
+
+    private:
+        // 
+        // Holds the states that the port is transitioning through
+        // 
+        PinSet state[NUM_BUTTON_STATES];
+
+        // 
+        // The debounced state, the pins that just changed and the pullups
+        // 
+        PinSet debouncedState;
+        PinSet changed;
+        PinSet pullType;
+
+        // 
+        // Keeps up with where to store the next port status
+        // 
+        uint8_t index;
+};
+
+//*********************************************************************************
+// Pin Set Functions
+//*********************************************************************************
+template<uint32_t NumPins>
+ButtonPinSet<NumPins>::
+ButtonPinSet()
+{
+    uint32_t i;
+
+    for(i = 0; i < NumWords; i++)
+    {
+        words[i] = 0;
+    }
+}
+
+template<uint32_t NumPins>
+uint64_t ButtonPinSet<NumPins>::
+LastWordMask()
+{
+    return NumPins % BUTTON_WIDE_WORD_BITS == 0 ? ~(uint64_t)0 :
+           ((uint64_t)1 << (NumPins % BUTTON_WIDE_WORD_BITS)) - 1;
+}
+
+template<uint32_t NumPins>
+ButtonPinSet<NumPins> ButtonPinSet<NumPins>::
+All()
+{
+    ButtonPinSet set;
+    uint32_t i;
+
+    for(i = 0; i < NumWords; i++)
+    {
+        set.words[i] = ~(uint64_t)0;
+    }
+    set.words[NumWords - 1] &= LastWordMask();
+
+    return set;
+}
+
+template<uint32_t NumPins>
+void ButtonPinSet<NumPins>::
+LoadBytes(const uint8_t *bytes)
+{
+    const uint32_t numBytes = (NumPins + 7) / 8;
+    uint32_t i;
+
+    for(i = 0; i < NumWords; i++)
+    {
+        words[i] = 0;
+    }
+
+    // Builds each word from its bytes so that the layout doesn't depend on
+    // the processor's byte order
+    for(i = 0; i < numBytes; i++)
+    {
+        words[i / 8] |= (uint64_t)bytes[i] << (8 * (i % 8));
+    }
+    words[NumWords - 1] &= LastWordMask();
+}
+
+template<uint32_t NumPins>
+void ButtonPinSet<NumPins>::
+Set(uint32_t pin)
+{
+    words[pin / BUTTON_WIDE_WORD_BITS] |= (uint64_t)1 << (pin % BUTTON_WIDE_WORD_BITS);
+}
+
+template<uint32_t NumPins>
+void ButtonPinSet<NumPins>::
+Clear(uint32_t pin)
+{
+    words[pin / BUTTON_WIDE_WORD_BITS] &= ~((uint64_t)1 << (pin % BUTTON_WIDE_WORD_BITS));
+}
+
+template<uint32_t NumPins>
+bool ButtonPinSet<NumPins>::
+Test(uint32_t pin) const
+{
+    return ((words[pin / BUTTON_WIDE_WORD_BITS] >> (pin % BUTTON_WIDE_WORD_BITS)) & 1) != 0;
+}
+
+template<uint32_t NumPins>
+bool ButtonPinSet<NumPins>::
+Any() const
+{
+    uint64_t any = 0;
+    uint32_t i;
+
+    for(i = 0; i < NumWords; i++)
+    {
+        any |= words[i];
+    }
+
+    return any != 0;
+}
+
+template<uint32_t NumPins>
+uint32_t ButtonPinSet<NumPins>::
+Count() const
+{
+    uint32_t count = 0;
+    uint32_t i;
+
+    for(i = 0; i < NumWords; i++)
+    {
+        count += __builtin_popcountll(words[i]);
+    }
+
+    return count;
+}
+
+template<uint32_t NumPins>
+uint32_t ButtonPinSet<NumPins>::
+NextPin(uint32_t pin) const
+{
+    uint32_t word = pin / BUTTON_WIDE_WORD_BITS;
+    uint64_t bits;
+
+    if(pin >= NumPins)
+    {
+        return NumPins;
+    }
+
+    // Drop the pins of the first word below pin, then skip empty words
+    bits = words[word] & (~(uint64_t)0 << (pin % BUTTON_WIDE_WORD_BITS));
+    while(bits == 0)
+    {
+        word++;
+        if(word >= NumWords)
+        {
+            return NumPins;
+        }
+        bits = words[word];
+    }
+
+    return word * BUTTON_WIDE_WORD_BITS + __builtin_ctzll(bits);
+}
+
+template<uint32_t NumPins>
+uint64_t &ButtonPinSet<NumPins>::
+Word(uint32_t word)
+{
+    return words[word];
+}
+
+template<uint32_t NumPins>
+uint64_t ButtonPinSet<NumPins>::
+Word(uint32_t word) const
+{
+    return words[word];
+}
+
+template<uint32_t NumPins>
+ButtonPinSet<NumPins> ButtonPinSet<NumPins>::
+operator&(const ButtonPinSet &other) const
+{
+    ButtonPinSet result;
+    uint32_t i;
+
+    for(i = 0; i < NumWords; i++)
+    {
+        result.words[i] = words[i] & other.words[i];
+    }
+
+    return result;
+}
+
+template<uint32_t NumPins>
+ButtonPinSet<NumPins> ButtonPinSet<NumPins>::
+operator|(const ButtonPinSet &other) const
+{
+    ButtonPinSet result;
+    uint32_t i;
+
+    for(i = 0; i < NumWords; i++)
+    {
+        result.words[i] = words[i] | other.words[i];
+    }
+
+    return result;
+}
+
+template<uint32_t NumPins>
+ButtonPinSet<NumPins> ButtonPinSet<NumPins>::
+operator^(const ButtonPinSet &other) const
+{
+    ButtonPinSet result;
+    uint32_t i;
+
+    for(i = 0; i < NumWords; i++)
+    {
+        result.words[i] = words[i] ^ other.words[i];
+    }
+
+    return result;
+}
+
+template<uint32_t NumPins>
+ButtonPinSet<NumPins> ButtonPinSet<NumPins>::
+operator~() const
+{
+    ButtonPinSet result;
+    uint32_t i;
+
+    for(i = 0; i < NumWords; i++)
+    {
+        result.words[i] = ~words[i];
+    }
+    result.words[NumWords - 1] &= LastWordMask();
+
+    return result;
+}
+
+template<uint32_t NumPins>
+ButtonPinSet<NumPins> &ButtonPinSet<NumPins>::
+operator&=(const ButtonPinSet &other)
+{
+    uint32_t i;
+
+    for(i = 0; i < NumWords; i++)
+    {
+        words[i] &= other.words[i];
+    }
+
+    return *this;
+}
+
+template<uint32_t NumPins>
+bool ButtonPinSet<NumPins>::
+operator==(const ButtonPinSet &other) const
+{
+    uint64_t difference = 0;
+    uint32_t i;
+
+    for(i = 0; i < NumWords; i++)
+    {
+        difference |= words[i] ^ other.words[i];
+    }
+
+    return difference == 0;
+}
+
+template<uint32_t NumPins>
+bool ButtonPinSet<NumPins>::
+operator!=(const ButtonPinSet &other) const
+{
+    return !(*this == other);
+}
+
+//*********************************************************************************
+// Debouncer Functions
+//*********************************************************************************
+template<uint32_t NumPins>
+WideDebouncer<NumPins>::
+WideDebouncer(const PinSet &pulledUpButtons)
+{
+    // The pin sets start out empty
+    pullType = pulledUpButtons;
+    index = 0;
+}
+
+template<uint32_t NumPins>
+void WideDebouncer<NumPins>::
+ButtonProcess(const PinSet &portStatus)
+{
+    PinSet lastDebouncedState = debouncedState;
+    uint8_t i;
+
+    // Save the port status, flipping the pulled up pins so that a 1 bit
+    // always means pressed
+    state[index] = portStatus ^ pullType;
+
+    // Debounce the buttons
+    debouncedState = PinSet::All();
+    for(i = 0; i < NUM_BUTTON_STATES; i++)
+    {
+        debouncedState &= state[i];
+    }
+
+    // Check to make sure the index hasn't gone over the limit
+    index++;
+    if(index >= NUM_BUTTON_STATES)
+    {
+        index = 0;
+    }
+
+    changed = debouncedState ^ lastDebouncedState;
+}
+
+template<uint32_t NumPins>
+ButtonPinSet<NumPins> WideDebouncer<NumPins>::
+ButtonPressed(const PinSet &GPIOButtonPins) const
+{
+    return (changed & debouncedState) & GPIOButtonPins;
+}
+
+template<uint32_t NumPins>
+ButtonPinSet<NumPins> WideDebouncer<NumPins>::
+ButtonReleased(const PinSet &GPIOButtonPins) const
+{
+    return (changed & ~debouncedState) & GPIOButtonPins;
+}
+
+template<uint32_t NumPins>
+ButtonPinSet<NumPins> WideDebouncer<NumPins>::
+ButtonCurrent(const PinSet &GPIOButtonPins) const
+{
+    return debouncedState & GPIOButtonPins;
+}
+
+#endif  // BUTTON_DEBOUNCER_WIDE_H